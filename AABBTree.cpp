@@ -0,0 +1,249 @@
+#include "AABBTree.hpp"
+
+#include <algorithm>
+
+AABB AABB::from_points(glm::vec3 const *points, uint32_t count) {
+	AABB ret;
+	for (uint32_t i = 0; i < count; ++i) {
+		ret.min = glm::min(ret.min, points[i]);
+		ret.max = glm::max(ret.max, points[i]);
+	}
+	return ret;
+}
+
+AABB AABB::around_segment(glm::vec3 const &a, glm::vec3 const &b, float radius) {
+	return AABB(glm::min(a, b) - glm::vec3(radius), glm::max(a, b) + glm::vec3(radius));
+}
+
+bool AABB::ray_overlaps(glm::vec3 const &origin, glm::vec3 const &dir, float max_t) const {
+	float enter = 0.0f;
+	float exit = max_t;
+	for (uint32_t i = 0; i < 3; ++i) {
+		if (dir[i] == 0.0f) {
+			if (origin[i] < min[i] || origin[i] > max[i]) return false;
+			continue;
+		}
+		float t0 = (min[i] - origin[i]) / dir[i];
+		float t1 = (max[i] - origin[i]) / dir[i];
+		if (t0 > t1) std::swap(t0, t1);
+		enter = std::max(enter, t0);
+		exit = std::min(exit, t1);
+		if (enter > exit) return false;
+	}
+	return true;
+}
+
+//-------------------------
+
+int32_t AABBTree::allocate_node() {
+	if (free_list == Null) {
+		nodes.emplace_back();
+		return int32_t(nodes.size()) - 1;
+	}
+	int32_t node = free_list;
+	free_list = nodes[node].parent;
+	nodes[node] = Node();
+	return node;
+}
+
+void AABBTree::free_node(int32_t node) {
+	assert(node >= 0 && node < int32_t(nodes.size()));
+	nodes[node].parent = free_list;
+	nodes[node].height = -1;
+	free_list = node;
+}
+
+void AABBTree::clear() {
+	nodes.clear();
+	root = Null;
+	free_list = Null;
+	leaf_count = 0;
+}
+
+int32_t AABBTree::insert(AABB const &box, uint32_t user) {
+	int32_t proxy = allocate_node();
+	nodes[proxy].box = box.expanded(margin);
+	nodes[proxy].user = user;
+	nodes[proxy].height = 0;
+	insert_leaf(proxy);
+	leaf_count += 1;
+	return proxy;
+}
+
+void AABBTree::remove(int32_t proxy) {
+	assert(proxy >= 0 && proxy < int32_t(nodes.size()));
+	assert(nodes[proxy].is_leaf());
+	remove_leaf(proxy);
+	free_node(proxy);
+	leaf_count -= 1;
+}
+
+bool AABBTree::move(int32_t proxy, AABB const &box) {
+	assert(proxy >= 0 && proxy < int32_t(nodes.size()));
+	assert(nodes[proxy].is_leaf());
+
+	//still inside the fat box? nothing to do:
+	if (nodes[proxy].box.contains(box)) return false;
+
+	remove_leaf(proxy);
+	nodes[proxy].box = box.expanded(margin);
+	insert_leaf(proxy);
+	return true;
+}
+
+//-------------------------
+
+void AABBTree::insert_leaf(int32_t leaf) {
+	if (root == Null) {
+		root = leaf;
+		nodes[root].parent = Null;
+		return;
+	}
+
+	//find the best sibling by walking down the tree, using the
+	// surface area heuristic to decide which way to go:
+	AABB leaf_box = nodes[leaf].box;
+	int32_t index = root;
+	while (!nodes[index].is_leaf()) {
+		int32_t left = nodes[index].left;
+		int32_t right = nodes[index].right;
+
+		float area = nodes[index].box.surface_area();
+		float combined_area = nodes[index].box.merged(leaf_box).surface_area();
+
+		//cost of making a new parent for this node and the new leaf:
+		float cost = 2.0f * combined_area;
+		//minimum cost of pushing the leaf further down the tree:
+		float inheritance_cost = 2.0f * (combined_area - area);
+
+		auto descend_cost = [&](int32_t child) {
+			AABB box = leaf_box.merged(nodes[child].box);
+			if (nodes[child].is_leaf()) {
+				return box.surface_area() + inheritance_cost;
+			} else {
+				return box.surface_area() - nodes[child].box.surface_area() + inheritance_cost;
+			}
+		};
+		float cost_left = descend_cost(left);
+		float cost_right = descend_cost(right);
+
+		if (cost < cost_left && cost < cost_right) break;
+		index = (cost_left < cost_right ? left : right);
+	}
+	int32_t sibling = index;
+
+	//make a new parent holding the sibling and the leaf:
+	int32_t old_parent = nodes[sibling].parent;
+	int32_t new_parent = allocate_node();
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].box = leaf_box.merged(nodes[sibling].box);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].left = sibling;
+	nodes[new_parent].right = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent != Null) {
+		if (nodes[old_parent].left == sibling) nodes[old_parent].left = new_parent;
+		else nodes[old_parent].right = new_parent;
+	} else {
+		root = new_parent;
+	}
+
+	//walk back up, fixing heights and boxes:
+	index = nodes[leaf].parent;
+	while (index != Null) {
+		index = balance(index);
+
+		int32_t left = nodes[index].left;
+		int32_t right = nodes[index].right;
+		nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+		nodes[index].box = nodes[left].box.merged(nodes[right].box);
+
+		index = nodes[index].parent;
+	}
+}
+
+void AABBTree::remove_leaf(int32_t leaf) {
+	if (leaf == root) {
+		root = Null;
+		return;
+	}
+
+	int32_t parent = nodes[leaf].parent;
+	int32_t grand_parent = nodes[parent].parent;
+	int32_t sibling = (nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left);
+
+	if (grand_parent != Null) {
+		//splice the sibling into the parent's spot:
+		if (nodes[grand_parent].left == parent) nodes[grand_parent].left = sibling;
+		else nodes[grand_parent].right = sibling;
+		nodes[sibling].parent = grand_parent;
+		free_node(parent);
+
+		int32_t index = grand_parent;
+		while (index != Null) {
+			index = balance(index);
+
+			int32_t left = nodes[index].left;
+			int32_t right = nodes[index].right;
+			nodes[index].box = nodes[left].box.merged(nodes[right].box);
+			nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+
+			index = nodes[index].parent;
+		}
+	} else {
+		root = sibling;
+		nodes[sibling].parent = Null;
+		free_node(parent);
+	}
+}
+
+//Perform a left or right rotation if node 'a' is imbalanced; returns the new root of the subtree:
+int32_t AABBTree::balance(int32_t a) {
+	assert(a != Null);
+
+	Node &A = nodes[a];
+	if (A.is_leaf() || A.height < 2) return a;
+
+	int32_t b = A.left;
+	int32_t c = A.right;
+	int32_t skew = nodes[c].height - nodes[b].height;
+
+	//rotate 'c' up (or, symmetrically, 'b' up):
+	auto rotate_up = [this](int32_t a, int32_t up, int32_t other) {
+		Node &A = nodes[a];
+		Node &U = nodes[up];
+		int32_t f = U.left;
+		int32_t g = U.right;
+
+		U.left = a;
+		U.parent = A.parent;
+		A.parent = up;
+
+		if (U.parent != Null) {
+			if (nodes[U.parent].left == a) nodes[U.parent].left = up;
+			else nodes[U.parent].right = up;
+		} else {
+			root = up;
+		}
+
+		//keep the taller grandchild under 'up', hand the shorter one to 'a':
+		int32_t keep = (nodes[f].height > nodes[g].height ? f : g);
+		int32_t give = (keep == f ? g : f);
+		U.right = keep;
+		if (A.left == up) A.left = give;
+		else A.right = give;
+		nodes[give].parent = a;
+
+		A.box = nodes[other].box.merged(nodes[give].box);
+		U.box = A.box.merged(nodes[keep].box);
+		A.height = 1 + std::max(nodes[other].height, nodes[give].height);
+		U.height = 1 + std::max(A.height, nodes[keep].height);
+		return up;
+	};
+
+	if (skew > 1) return rotate_up(a, c, b);
+	if (skew < -1) return rotate_up(a, b, c);
+	return a;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+/*
+ * An "AABBTree" is a dynamic bounding volume hierarchy over axis-aligned boxes.
+ *
+ * Each leaf ("proxy") keeps a slightly enlarged ("fat") copy of the box it was
+ *  given, so objects that only move a little can be refit without touching the
+ *  tree at all. Internal nodes store the union of their two children, and the
+ *  tree is kept height-balanced with AVL-style rotations.
+ *
+ * Queries only descend into branches whose boxes overlap the query box, so the
+ *  cost of a query grows with the number of nearby proxies instead of the total.
+ *
+ * The structure closely follows b2DynamicTree from Box2D (Erin Catto).
+ *
+ */
+
+#include <glm/glm.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+struct AABB {
+	glm::vec3 min = glm::vec3( std::numeric_limits< float >::infinity());
+	glm::vec3 max = glm::vec3(-std::numeric_limits< float >::infinity());
+
+	AABB() = default;
+	AABB(glm::vec3 const &min_, glm::vec3 const &max_) : min(min_), max(max_) { }
+
+	//smallest box containing all of the given points:
+	static AABB from_points(glm::vec3 const *points, uint32_t count);
+	//smallest box containing a capsule (or swept sphere) from 'a' to 'b':
+	static AABB around_segment(glm::vec3 const &a, glm::vec3 const &b, float radius);
+
+	//does the ray origin + t * dir pass through the box for some t in [0, max_t]?
+	bool ray_overlaps(glm::vec3 const &origin, glm::vec3 const &dir, float max_t) const;
+
+	bool overlaps(AABB const &o) const {
+		return min.x <= o.max.x && o.min.x <= max.x
+		    && min.y <= o.max.y && o.min.y <= max.y
+		    && min.z <= o.max.z && o.min.z <= max.z;
+	}
+	bool contains(AABB const &o) const {
+		return min.x <= o.min.x && min.y <= o.min.y && min.z <= o.min.z
+		    && o.max.x <= max.x && o.max.y <= max.y && o.max.z <= max.z;
+	}
+	AABB merged(AABB const &o) const { return AABB(glm::min(min, o.min), glm::max(max, o.max)); }
+	AABB expanded(float r) const { return AABB(min - glm::vec3(r), max + glm::vec3(r)); }
+	float surface_area() const {
+		glm::vec3 d = max - min;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+};
+
+struct AABBTree {
+	//add a box to the tree; returns a proxy id that stays valid until 'remove':
+	// 'user' is an arbitrary value handed back by queries (e.g., an index into an object list)
+	int32_t insert(AABB const &box, uint32_t user);
+	void remove(int32_t proxy);
+
+	//update a proxy's box after its object moved:
+	// returns true if the proxy left its fat box and had to be reinserted
+	bool move(int32_t proxy, AABB const &box);
+
+	uint32_t get_user(int32_t proxy) const { assert(proxy >= 0 && proxy < int32_t(nodes.size())); return nodes[proxy].user; }
+	void set_user(int32_t proxy, uint32_t user) { assert(proxy >= 0 && proxy < int32_t(nodes.size())); nodes[proxy].user = user; }
+	AABB const &get_fat_box(int32_t proxy) const { assert(proxy >= 0 && proxy < int32_t(nodes.size())); return nodes[proxy].box; }
+
+	//call 'fn(user)' for every proxy whose fat box overlaps 'box':
+	// 'fn' returns false to stop the query early
+	template< typename F >
+	void query(AABB const &box, F const &fn) const;
+
+	//call 'fn(user, max_t)' for every proxy whose fat box the ray origin + t * dir, t in [0, max_t], passes through:
+	// 'fn' returns the new max_t (e.g. the t of a hit it found, so boxes behind it are skipped; 0 to stop)
+	template< typename F >
+	void raycast(glm::vec3 const &origin, glm::vec3 const &dir, float max_t, F const &fn) const;
+
+	void clear();
+	uint32_t proxy_count() const { return leaf_count; }
+	int32_t height() const { return root == Null ? 0 : nodes[root].height; }
+
+	//how much to grow leaf boxes so that small motions don't need a reinsert:
+	float margin = 0.1f;
+
+	//-- internals ---
+	enum : int32_t { Null = -1 };
+	struct Node {
+		AABB box;
+		uint32_t user = 0;
+		int32_t parent = Null; //doubles as 'next' link while on the free list
+		int32_t left = Null;
+		int32_t right = Null;
+		int32_t height = 0; //leaf = 0, free = -1
+		bool is_leaf() const { return left == Null; }
+	};
+	std::vector< Node > nodes;
+	int32_t root = Null;
+	int32_t free_list = Null;
+	uint32_t leaf_count = 0;
+
+	int32_t allocate_node();
+	void free_node(int32_t node);
+	void insert_leaf(int32_t leaf);
+	void remove_leaf(int32_t leaf);
+	int32_t balance(int32_t a);
+};
+
+template< typename F >
+void AABBTree::query(AABB const &box, F const &fn) const {
+	if (root == Null) return;
+
+	//AVL balancing keeps height ~1.44 log2(n), so this is plenty:
+	int32_t stack[64];
+	uint32_t top = 0;
+	stack[top++] = root;
+	while (top > 0) {
+		Node const &node = nodes[stack[--top]];
+		if (!node.box.overlaps(box)) continue;
+		if (node.is_leaf()) {
+			if (!fn(node.user)) return;
+		} else {
+			assert(top + 2 <= 64);
+			stack[top++] = node.left;
+			stack[top++] = node.right;
+		}
+	}
+}
+
+template< typename F >
+void AABBTree::raycast(glm::vec3 const &origin, glm::vec3 const &dir, float max_t, F const &fn) const {
+	if (root == Null) return;
+
+	int32_t stack[64];
+	uint32_t top = 0;
+	stack[top++] = root;
+	while (top > 0) {
+		Node const &node = nodes[stack[--top]];
+		if (!node.box.ray_overlaps(origin, dir, max_t)) continue;
+		if (node.is_leaf()) {
+			max_t = fn(node.user, max_t);
+			if (max_t <= 0.0f) return;
+		} else {
+			assert(top + 2 <= 64);
+			stack[top++] = node.left;
+			stack[top++] = node.right;
+		}
+	}
+}
@@ -1,8 +1,14 @@
 #include "Collision.hpp"
 
-glm::vec3 center_ = glm::vec3(0.f);
-glm::vec3 tri_point_ = glm::vec3(0.f);
-bool is_side_ = false;
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLISION_USE_SSE
+#include <emmintrin.h>
+#endif
 
 glm::vec3 closest_point_on_line_segment(glm::vec3 A, glm::vec3 B, glm::vec3 Point) {
     glm::vec3 AB = B - A;
@@ -11,11 +17,11 @@ glm::vec3 closest_point_on_line_segment(glm::vec3 A, glm::vec3 B, glm::vec3 Poin
 }
 
 // SOURCE: https://wickedengine.net/2020/04/26/capsule-collision-detection/
-bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
-                                glm::vec3 *pen_normal, float *pen_depth) {
+// N is the unit plane normal, normalize(cross(p1 - p0, p2 - p0))
+static bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 N,
+                                      CollisionResult *result) {
     // float3 p0, p1, p2; // triangle corners
     // float3 center; // sphere center
-    glm::vec3 N = glm::normalize(glm::cross(p1 - p0, p2 - p0)); // plane normal
     float dist = glm::dot(center - p0, N); // signed distance between sphere and plane
     // if (!mesh.is_double_sided() && dist > 0) continue; // can pass through back side of triangle (optional)
     if (dist < -radius || dist > radius) {
@@ -80,22 +86,33 @@ bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm
             }
         }
 
-        if (is_side_) {
-            center_ = center;
-            tri_point_ = best_point;
-        }
-        
         float len = glm::length(intersection_vec);
-        *pen_normal = glm::normalize(intersection_vec);
-        *pen_depth = radius - len;
+        result->point = best_point;
+        result->normal = glm::normalize(intersection_vec);
+        result->depth = radius - len;
         return true;
     }
 
     return false;
 }
 
-bool parallel_capsule_triangle_collision(glm::vec3 A, glm::vec3 B, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, float radius, 
-                                         glm::vec3 *pen_normal, float *pen_depth) {
+bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+                               CollisionResult *result) {
+    glm::vec3 N = glm::normalize(glm::cross(p1 - p0, p2 - p0)); // plane normal
+    return sphere_triangle_collision(center, radius, p0, p1, p2, N, result);
+}
+
+bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+                                glm::vec3 *pen_normal, float *pen_depth) {
+    CollisionResult result;
+    if (!sphere_triangle_collision(center, radius, p0, p1, p2, &result)) return false;
+    *pen_normal = result.normal;
+    *pen_depth = result.depth;
+    return true;
+}
+
+// sphere center to test when the capsule runs parallel to the triangle plane
+static glm::vec3 parallel_capsule_center(glm::vec3 A, glm::vec3 B, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2) {
     glm::vec3 close0 = closest_point_on_line_segment(A, B, p0);
     glm::vec3 close1 = closest_point_on_line_segment(A, B, p1);
     glm::vec3 close2 = closest_point_on_line_segment(A, B, p2);
@@ -115,13 +132,30 @@ bool parallel_capsule_triangle_collision(glm::vec3 A, glm::vec3 B, glm::vec3 p0,
         d = temp_d;
     }
 
+    return center;
+}
+
+bool parallel_capsule_triangle_collision(glm::vec3 A, glm::vec3 B, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, float radius, 
+                                         glm::vec3 *pen_normal, float *pen_depth) {
+    glm::vec3 center = parallel_capsule_center(A, B, p0, p1, p2);
     return sphere_triangle_collision(center, radius, p0, p1, p2, pen_normal, pen_depth);
 }
 
+// sphere center on the capsule segment closest to the triangle (debug capture only reads it back)
+static bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 N,
+                                      CollisionResult *result, CollisionDebug *debug) {
+    if (!sphere_triangle_collision(center, radius, p0, p1, p2, N, result)) return false;
+    if (debug) {
+        debug->segment_point = center;
+        debug->surface_point = result->point;
+    }
+    return true;
+}
+
 // SOURCE: https://wickedengine.net/2020/04/26/capsule-collision-detection/
 // Note for triangle normal, p0, p1, p2 matters
-bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
-                                glm::vec3 *pen_normal, float *pen_depth) {
+static bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 N,
+                                       CollisionResult *result, CollisionDebug *debug) {
     // Compute capsule line endpoints A, B like before in capsule-capsule case:
     glm::vec3 CapsuleNormal = glm::normalize(tip - base); 
     glm::vec3 LineEndOffset = CapsuleNormal * radius; 
@@ -130,10 +164,9 @@ bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm
     
     // Then for each triangle, ray-plane intersection:
     //  N is the triangle plane normal (it was computed in sphere - triangle intersection case)
-    glm::vec3 N = glm::normalize(glm::cross(p1 - p0, p2 - p0)); // plane normal
-
     if (std::abs(glm::dot(N, CapsuleNormal)) == 0.f) {
-        return parallel_capsule_triangle_collision(A, B, p0, p1, p2, radius, pen_normal, pen_depth);
+        glm::vec3 center = parallel_capsule_center(A, B, p0, p1, p2);
+        return sphere_triangle_collision(center, radius, p0, p1, p2, N, result, debug);
     }
 
 
@@ -182,9 +215,25 @@ bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm
     // The center of the best sphere candidate:
     glm::vec3 center = closest_point_on_line_segment(A, B, reference_point);
 
-    return sphere_triangle_collision(center, radius, p0, p1, p2, pen_normal, pen_depth);
+    return sphere_triangle_collision(center, radius, p0, p1, p2, N, result, debug);
 }
 
+bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+                                CollisionResult *result, CollisionDebug *debug) {
+    glm::vec3 N = glm::normalize(glm::cross(p1 - p0, p2 - p0)); // plane normal
+    return capsule_triangle_collision(tip, base, radius, p0, p1, p2, N, result, debug);
+}
+
+bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+                                glm::vec3 *pen_normal, float *pen_depth) {
+    CollisionResult result;
+    if (!capsule_triangle_collision(tip, base, radius, p0, p1, p2, &result)) return false;
+    *pen_normal = result.normal;
+    *pen_depth = result.depth;
+    return true;
+}
+
+
 bool is_almost_up_vec(glm::vec3 &v) {
     glm::vec3 n_v = glm::normalize(v);
     glm::vec3 n_v_swapped = n_v;
@@ -240,81 +289,656 @@ bool capsule_rectagle_collision(glm::vec3 tip, glm::vec3 base, float radius,
     return collide1 || collide2;
 }
 
-bool capsule_bbox_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 *p, 
+void TriangleBatch::push(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2) {
+    assert(count < Width);
+    glm::vec3 N = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+    p0x[count] = p0.x; p0y[count] = p0.y; p0z[count] = p0.z;
+    p1x[count] = p1.x; p1y[count] = p1.y; p1z[count] = p1.z;
+    p2x[count] = p2.x; p2y[count] = p2.y; p2z[count] = p2.z;
+    nx[count] = N.x; ny[count] = N.y; nz[count] = N.z;
+    count += 1;
+}
+
+void make_bbox_batches(glm::vec3 const *p, TriangleBatch batches[3]) {
+    // same corner order as the capsule_rectagle_collision calls in capsule_bbox_collision,
+    // split into triangles the same way (p0, p3, p1) and (p2, p1, p3)
+    static uint32_t const rects[6][4] = {
+        {6, 5, 1, 2}, // top
+        {4, 7, 3, 0}, // bottom
+        {4, 5, 6, 7}, // left
+        {3, 2, 1, 0}, // right
+        {7, 6, 2, 3}, // front
+        {0, 1, 5, 4}, // back
+    };
+    for (uint32_t b = 0; b < 3; b++) {
+        batches[b].count = 0;
+    }
+    uint32_t tri = 0;
+    for (auto const &r : rects) {
+        batches[tri / TriangleBatch::Width].push(p[r[0]], p[r[3]], p[r[1]]);
+        tri++;
+        batches[tri / TriangleBatch::Width].push(p[r[2]], p[r[1]], p[r[3]]);
+        tri++;
+    }
+}
+
+bool capsule_triangle_batch_collision_scalar(glm::vec3 tip, glm::vec3 base, float radius, 
+                                             TriangleBatch const *batches, uint32_t batch_count,
+                                             CollisionResult *result, uint32_t *hit_index, CollisionDebug *debug) {
+    bool hit = false;
+    for (uint32_t b = 0; b < batch_count; b++) {
+        TriangleBatch const &batch = batches[b];
+        for (uint32_t i = 0; i < batch.count; i++) {
+            glm::vec3 p0 = glm::vec3(batch.p0x[i], batch.p0y[i], batch.p0z[i]);
+            glm::vec3 p1 = glm::vec3(batch.p1x[i], batch.p1y[i], batch.p1z[i]);
+            glm::vec3 p2 = glm::vec3(batch.p2x[i], batch.p2y[i], batch.p2z[i]);
+            glm::vec3 N  = glm::vec3(batch.nx[i], batch.ny[i], batch.nz[i]);
+
+            CollisionResult candidate;
+            CollisionDebug candidate_debug;
+            if (!capsule_triangle_collision(tip, base, radius, p0, p1, p2, N, &candidate, debug ? &candidate_debug : nullptr)) continue;
+            if (!hit || candidate.depth > result->depth) {
+                hit = true;
+                result->point = candidate.point;
+                result->normal = candidate.normal;
+                result->depth = candidate.depth;
+                *hit_index = b * TriangleBatch::Width + i;
+                if (debug) *debug = candidate_debug;
+            }
+        }
+    }
+    return hit;
+}
+
+#ifdef COLLISION_USE_SSE
+
+// Four-wide versions of the scalar routines above. Every step follows the scalar operation
+// order so both paths agree (down to the lane that wins a tie on depth).
+namespace {
+    struct Vec3x4 {
+        __m128 x, y, z;
+    };
+
+    inline Vec3x4 splat(glm::vec3 v) {
+        return Vec3x4{ _mm_set1_ps(v.x), _mm_set1_ps(v.y), _mm_set1_ps(v.z) };
+    }
+    inline Vec3x4 load(float const *x, float const *y, float const *z) {
+        return Vec3x4{ _mm_load_ps(x), _mm_load_ps(y), _mm_load_ps(z) };
+    }
+    inline Vec3x4 operator+(Vec3x4 a, Vec3x4 b) {
+        return Vec3x4{ _mm_add_ps(a.x, b.x), _mm_add_ps(a.y, b.y), _mm_add_ps(a.z, b.z) };
+    }
+    inline Vec3x4 operator-(Vec3x4 a, Vec3x4 b) {
+        return Vec3x4{ _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) };
+    }
+    inline Vec3x4 operator*(Vec3x4 a, __m128 s) {
+        return Vec3x4{ _mm_mul_ps(a.x, s), _mm_mul_ps(a.y, s), _mm_mul_ps(a.z, s) };
+    }
+    inline Vec3x4 operator/(Vec3x4 a, __m128 s) {
+        return Vec3x4{ _mm_div_ps(a.x, s), _mm_div_ps(a.y, s), _mm_div_ps(a.z, s) };
+    }
+    inline __m128 dot(Vec3x4 a, Vec3x4 b) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+    }
+    inline Vec3x4 cross(Vec3x4 a, Vec3x4 b) {
+        return Vec3x4{
+            _mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(b.y, a.z)),
+            _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(b.z, a.x)),
+            _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(b.x, a.y)),
+        };
+    }
+    // mask ? a : b
+    inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    inline Vec3x4 select(__m128 mask, Vec3x4 a, Vec3x4 b) {
+        return Vec3x4{ select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z) };
+    }
+
+    inline Vec3x4 closest_point_on_line_segment(Vec3x4 A, Vec3x4 B, Vec3x4 Point) {
+        Vec3x4 AB = B - A;
+        __m128 t = _mm_div_ps(dot(Point - A, AB), dot(AB, AB));
+        // std::min(std::max(t, 0.f), 1.f), including how it passes NaN through:
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.f);
+        t = select(_mm_cmplt_ps(t, zero), zero, t);
+        t = select(_mm_cmplt_ps(one, t), one, t);
+        return A + AB * t;
+    }
+
+    // dot(cross(q - p0, p1 - p0), N) <= 0 for all three edges
+    inline __m128 inside_triangle(Vec3x4 q, Vec3x4 p0, Vec3x4 p1, Vec3x4 p2, Vec3x4 N) {
+        __m128 zero = _mm_setzero_ps();
+        __m128 in0 = _mm_cmple_ps(dot(cross(q - p0, p1 - p0), N), zero);
+        __m128 in1 = _mm_cmple_ps(dot(cross(q - p1, p2 - p1), N), zero);
+        __m128 in2 = _mm_cmple_ps(dot(cross(q - p2, p0 - p2), N), zero);
+        return _mm_and_ps(_mm_and_ps(in0, in1), in2);
+    }
+
+    inline glm::vec3 lane(Vec3x4 const &v, uint32_t i) {
+        alignas(16) float x[4], y[4], z[4];
+        _mm_store_ps(x, v.x);
+        _mm_store_ps(y, v.y);
+        _mm_store_ps(z, v.z);
+        return glm::vec3(x[i], y[i], z[i]);
+    }
+}
+
+bool capsule_triangle_batch_collision(glm::vec3 tip, glm::vec3 base, float radius, 
+                                      TriangleBatch const *batches, uint32_t batch_count,
+                                      CollisionResult *result, uint32_t *hit_index, CollisionDebug *debug) {
+    static_assert(TriangleBatch::Width == 4, "SSE path processes four triangles at a time");
+
+    // capsule line endpoints, as in capsule_triangle_collision:
+    glm::vec3 CapsuleNormal = glm::normalize(tip - base);
+    glm::vec3 LineEndOffset = CapsuleNormal * radius;
+    Vec3x4 A = splat(base + LineEndOffset);
+    Vec3x4 B = splat(tip - LineEndOffset);
+    Vec3x4 n = splat(CapsuleNormal);
+    Vec3x4 base4 = splat(base);
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 r = _mm_set1_ps(radius);
+    __m128 neg_r = _mm_set1_ps(-radius);
+    __m128 radiussq = _mm_set1_ps(radius * radius);
+    __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 lane_index = _mm_castsi128_ps(_mm_set_epi32(3, 2, 1, 0));
+
+    bool hit = false;
+    for (uint32_t b = 0; b < batch_count; b++) {
+        TriangleBatch const &batch = batches[b];
+        if (batch.count == 0) continue;
+
+        Vec3x4 p0 = load(batch.p0x, batch.p0y, batch.p0z);
+        Vec3x4 p1 = load(batch.p1x, batch.p1y, batch.p1z);
+        Vec3x4 p2 = load(batch.p2x, batch.p2y, batch.p2z);
+        Vec3x4 N  = load(batch.nx, batch.ny, batch.nz);
+        __m128 in_use = _mm_castsi128_ps(_mm_cmplt_epi32(_mm_castps_si128(lane_index), _mm_set1_epi32(int32_t(batch.count))));
+
+        // --- pick the sphere center on the capsule segment (capsule_triangle_collision) ---
+        __m128 abs_ndotc = _mm_and_ps(dot(N, n), abs_mask);
+        __m128 parallel = _mm_cmpeq_ps(abs_ndotc, zero);
+
+        __m128 t = dot(N, (p0 - base4) / abs_ndotc);
+        Vec3x4 lpi = base4 + n * t;
+
+        Vec3x4 e1 = closest_point_on_line_segment(p0, p1, lpi);
+        Vec3x4 e2 = closest_point_on_line_segment(p1, p2, lpi);
+        Vec3x4 e3 = closest_point_on_line_segment(p2, p0, lpi);
+        __m128 d1 = dot(lpi - e1, lpi - e1);
+        __m128 d2 = dot(lpi - e2, lpi - e2);
+        __m128 d3 = dot(lpi - e3, lpi - e3);
+        Vec3x4 reference_point = e1;
+        __m128 best_dist = d1;
+        __m128 closer = _mm_cmplt_ps(d2, best_dist);
+        reference_point = select(closer, e2, reference_point);
+        best_dist = select(closer, d2, best_dist);
+        closer = _mm_cmplt_ps(d3, best_dist);
+        reference_point = select(closer, e3, reference_point);
+        reference_point = select(inside_triangle(lpi, p0, p1, p2, N), lpi, reference_point);
+        Vec3x4 center = closest_point_on_line_segment(A, B, reference_point);
+
+        // parallel lanes use parallel_capsule_center instead:
+        Vec3x4 close0 = closest_point_on_line_segment(A, B, p0);
+        Vec3x4 close1 = closest_point_on_line_segment(A, B, p1);
+        Vec3x4 close2 = closest_point_on_line_segment(A, B, p2);
+        __m128 pd = _mm_sqrt_ps(dot(close0 - p0, close0 - p0));
+        Vec3x4 parallel_center = close0;
+        __m128 temp_d = _mm_sqrt_ps(dot(close1 - p1, close1 - p1));
+        closer = _mm_cmplt_ps(temp_d, pd);
+        parallel_center = select(closer, close1, parallel_center);
+        pd = select(closer, temp_d, pd);
+        temp_d = _mm_sqrt_ps(dot(close2 - p2, close2 - p2));
+        closer = _mm_cmplt_ps(temp_d, pd);
+        parallel_center = select(closer, close2, parallel_center);
+        center = select(parallel, parallel_center, center);
+
+        // --- sphere vs triangle (sphere_triangle_collision) ---
+        __m128 dist = dot(center - p0, N);
+        __m128 near_plane = _mm_andnot_ps(_mm_or_ps(_mm_cmplt_ps(dist, neg_r), _mm_cmpgt_ps(dist, r)), in_use);
+        if (_mm_movemask_ps(near_plane) == 0) continue;
+
+        Vec3x4 point0 = center - N * dist;
+        __m128 inside = inside_triangle(point0, p0, p1, p2, N);
+
+        Vec3x4 q1 = closest_point_on_line_segment(p0, p1, center);
+        Vec3x4 q2 = closest_point_on_line_segment(p1, p2, center);
+        Vec3x4 q3 = closest_point_on_line_segment(p2, p0, center);
+        Vec3x4 v1 = center - q1;
+        Vec3x4 v2 = center - q2;
+        Vec3x4 v3 = center - q3;
+        __m128 distsq1 = dot(v1, v1);
+        __m128 distsq2 = dot(v2, v2);
+        __m128 distsq3 = dot(v3, v3);
+        __m128 intersects = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(distsq1, radiussq), _mm_cmplt_ps(distsq2, radiussq)),
+                                      _mm_cmplt_ps(distsq3, radiussq));
+
+        int hits = _mm_movemask_ps(_mm_and_ps(near_plane, _mm_or_ps(inside, intersects)));
+        if (hits == 0) continue;
+
+        Vec3x4 best_point = q1;
+        Vec3x4 intersection_vec = v1;
+        __m128 best_distsq = distsq1;
+        closer = _mm_cmplt_ps(distsq2, best_distsq);
+        best_point = select(closer, q2, best_point);
+        intersection_vec = select(closer, v2, intersection_vec);
+        best_distsq = select(closer, distsq2, best_distsq);
+        closer = _mm_cmplt_ps(distsq3, best_distsq);
+        best_point = select(closer, q3, best_point);
+        intersection_vec = select(closer, v3, intersection_vec);
+        best_point = select(inside, point0, best_point);
+        intersection_vec = select(inside, center - point0, intersection_vec);
+
+        __m128 len = _mm_sqrt_ps(dot(intersection_vec, intersection_vec));
+        Vec3x4 normal = intersection_vec * _mm_div_ps(_mm_set1_ps(1.f), len);
+        alignas(16) float depth[4];
+        _mm_store_ps(depth, _mm_sub_ps(r, len));
+
+        for (uint32_t i = 0; i < 4; i++) {
+            if (!(hits & (1 << i))) continue;
+            if (hit && !(depth[i] > result->depth)) continue;
+            hit = true;
+            result->point = lane(best_point, i);
+            result->normal = lane(normal, i);
+            result->depth = depth[i];
+            *hit_index = b * TriangleBatch::Width + i;
+            if (debug) {
+                debug->segment_point = lane(center, i);
+                debug->surface_point = result->point;
+            }
+        }
+    }
+    return hit;
+}
+
+#else
+
+bool capsule_triangle_batch_collision(glm::vec3 tip, glm::vec3 base, float radius, 
+                                      TriangleBatch const *batches, uint32_t batch_count,
+                                      CollisionResult *result, uint32_t *hit_index, CollisionDebug *debug) {
+    return capsule_triangle_batch_collision_scalar(tip, base, radius, batches, batch_count, result, hit_index, debug);
+}
+
+#endif
+
+bool capsule_bbox_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 const *p, 
                                 SurfaceType *surface, glm::vec3 *pen_normal, float *pen_depth) {
-    
-    // first check the standable surface
-    // if (standing_surface == TOP) {
-    //     if (capsule_rectagle_collision(tip, base, radius, p[6], p[5], p[1], p[2], pen_normal, pen_depth)) {
-    //         *surface = TOP;
-    //         return true;
-    //     }
-    // } else if (standing_surface == BOT) {
-    //     if (capsule_rectagle_collision(tip, base, radius, p[4], p[7], p[3], p[0], pen_normal, pen_depth)) {
-    //         *surface = BOT;
-    //         return true;
-    //     }
-    // } else if (standing_surface == LEFT) {
-    //     if (capsule_rectagle_collision(tip, base, radius, p[4], p[5], p[6], p[7], pen_normal, pen_depth)) {
-    //         *surface = LEFT;
-    //         return true;
-    //     }
-    // } else if (standing_surface == RIGHT) {
-    //     if (capsule_rectagle_collision(tip, base, radius, p[3], p[2], p[1], p[0], pen_normal, pen_depth)) {
-    //         *surface = RIGHT;
-    //         return true;
-    //     }
-    // } else if (standing_surface == FRONT) {
-    //     if (capsule_rectagle_collision(tip, base, radius, p[7], p[6], p[2], p[3], pen_normal, pen_depth)) {
-    //         *surface = FRONT;
-    //         return true;
-    //     }
-    // } else if (standing_surface == BACK) {
-    //     if (capsule_rectagle_collision(tip, base, radius, p[0], p[1], p[5], p[4], pen_normal, pen_depth)) {
-    //         *surface = BACK;
-    //         return true;
-    //     }
-    // }
-    
-    // top
-    if (capsule_rectagle_collision(tip, base, radius, p[6], p[5], p[1], p[2], pen_normal, pen_depth)) {
-        *surface = TOP;
-        return true;
+
+    CollisionResult result;
+    if (!capsule_obb_collision(tip, base, radius, make_oriented_box(p), &result)) return false;
+    *surface = result.face;
+    *pen_normal = result.normal;
+    *pen_depth = result.depth;
+    return true;
+}
+
+bool capsule_bbox_collision(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box, 
+                                CollisionResult *result, CollisionDebug *debug) {
+    return capsule_obb_collision(tip, base, radius, box, result, debug);
+}
+
+OrientedBox make_oriented_box(glm::vec3 const *p) {
+    OrientedBox box;
+
+    box.center = glm::vec3(0.f);
+    for (uint32_t i = 0; i < 8; i++) {
+        box.center += p[i];
+    }
+    box.center *= 1.f / 8.f;
+
+    // box edges toward LEFT, FRONT and TOP (see the corner lists in capsule_bbox_collision)
+    glm::vec3 edges[3] = {p[4] - p[0], p[3] - p[0], p[1] - p[0]};
+    glm::vec3 const world[3] = {glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f)};
+
+    // Gram-Schmidt the edges into an orthonormal frame; edges that collapse (e.g. a flat rug has no
+    // height) are filled in afterwards from the world axes, so they still point "up" / "left" / ...
+    bool valid[3] = {false, false, false};
+    auto orthogonalize = [&](glm::vec3 v) {
+        for (uint32_t j = 0; j < 3; j++) {
+            if (valid[j]) v -= glm::dot(v, box.axis[j]) * box.axis[j];
+        }
+        return v;
+    };
+    float scale = std::max({glm::dot(edges[0], edges[0]), glm::dot(edges[1], edges[1]), glm::dot(edges[2], edges[2])});
+    float epsilon = 1e-10f * scale;
+    for (uint32_t i = 0; i < 3; i++) {
+        glm::vec3 v = orthogonalize(edges[i]);
+        if (glm::dot(v, v) > epsilon && glm::dot(v, v) > 0.f) {
+            box.axis[i] = glm::normalize(v);
+            valid[i] = true;
+        }
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        if (valid[i]) continue;
+        // try the matching world axis first, then the others:
+        for (uint32_t k = 0; k < 3 && !valid[i]; k++) {
+            glm::vec3 v = orthogonalize(world[(i + k) % 3]);
+            if (glm::dot(v, v) > 1e-4f) {
+                box.axis[i] = glm::normalize(v);
+                valid[i] = true;
+            }
+        }
     }
 
-    // bottom
-    if (capsule_rectagle_collision(tip, base, radius, p[4], p[7], p[3], p[0], pen_normal, pen_depth)) {
-        *surface = BOT;
-        return true;
+    box.half = glm::vec3(0.f);
+    for (uint32_t i = 0; i < 8; i++) {
+        glm::vec3 d = p[i] - box.center;
+        for (uint32_t a = 0; a < 3; a++) {
+            box.half[a] = std::max(box.half[a], std::abs(glm::dot(d, box.axis[a])));
+        }
     }
+    return box;
+}
 
-    // left
-    if (capsule_rectagle_collision(tip, base, radius, p[4], p[5], p[6], p[7], pen_normal, pen_depth)) {
-        *surface = LEFT;
-        return true;
+// squared distance from the point a + t * d (box frame) to the box
+static float box_distance2(glm::vec3 a, glm::vec3 d, glm::vec3 half, float t) {
+    float dist2 = 0.f;
+    for (uint32_t i = 0; i < 3; i++) {
+        float x = a[i] + t * d[i];
+        float excess = std::max(x - half[i], 0.f) + std::max(-half[i] - x, 0.f);
+        dist2 += excess * excess;
     }
+    return dist2;
+}
 
-    // right
-    if (capsule_rectagle_collision(tip, base, radius, p[3], p[2], p[1], p[0], pen_normal, pen_depth)) {
-        *surface = RIGHT;
-        return true;
+// Parameter t in [0,1] of the point on segment a + t * d (box frame) closest to the box.
+// The squared distance is a convex piecewise quadratic in t whose pieces change where the
+// segment crosses a face plane, so minimize each piece in closed form and keep the best.
+static float closest_segment_parameter_to_box(glm::vec3 a, glm::vec3 d, glm::vec3 half) {
+    float breaks[8];
+    uint32_t count = 0;
+    breaks[count++] = 0.f;
+    for (uint32_t i = 0; i < 3; i++) {
+        if (d[i] == 0.f) continue;
+        float t_lo = (-half[i] - a[i]) / d[i];
+        float t_hi = ( half[i] - a[i]) / d[i];
+        if (t_lo > 0.f && t_lo < 1.f) breaks[count++] = t_lo;
+        if (t_hi > 0.f && t_hi < 1.f) breaks[count++] = t_hi;
+    }
+    breaks[count++] = 1.f;
+    // at most eight entries, insertion sort is plenty:
+    for (uint32_t i = 1; i < count; i++) {
+        for (uint32_t j = i; j > 0 && breaks[j] < breaks[j - 1]; j--) {
+            std::swap(breaks[j], breaks[j - 1]);
+        }
     }
 
-    // front
-    if (capsule_rectagle_collision(tip, base, radius, p[7], p[6], p[2], p[3], pen_normal, pen_depth)) {
-        *surface = FRONT;
-        return true;
+    float best_t = 0.f;
+    float best_dist2 = std::numeric_limits<float>::infinity();
+    for (uint32_t k = 0; k + 1 < count; k++) {
+        float lo = breaks[k];
+        float hi = breaks[k + 1];
+
+        // inside this piece each axis is either within the slab or clamped to one face:
+        float mid = 0.5f * (lo + hi);
+        float num = 0.f, den = 0.f;
+        for (uint32_t i = 0; i < 3; i++) {
+            float x = a[i] + mid * d[i];
+            float bound;
+            if (x > half[i]) bound = half[i];
+            else if (x < -half[i]) bound = -half[i];
+            else continue;
+            num += (a[i] - bound) * d[i];
+            den += d[i] * d[i];
+        }
+        float t = (den > 0.f ? std::min(std::max(-num / den, lo), hi) : lo);
+
+        float dist2 = box_distance2(a, d, half, t);
+        if (dist2 < best_dist2) {
+            best_dist2 = dist2;
+            best_t = t;
+        }
     }
+    return best_t;
+}
 
-    // back
-    if (capsule_rectagle_collision(tip, base, radius, p[0], p[1], p[5], p[4], pen_normal, pen_depth)) {
-        *surface = BACK;
-        return true;
+// faces[axis][positive side?]
+static SurfaceType const obb_faces[3][2] = {{RIGHT, LEFT}, {BACK, FRONT}, {BOT, TOP}};
+
+// capsule segment (line endpoints A, B like in capsule_triangle_collision) in the box frame, as a + t * d
+static void capsule_segment_in_box(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box,
+                                   glm::vec3 *a, glm::vec3 *d) {
+    glm::vec3 A = base, B = tip;
+    glm::vec3 axis = tip - base;
+    if (glm::dot(axis, axis) > 0.f) {
+        glm::vec3 LineEndOffset = glm::normalize(axis) * radius;
+        A = base + LineEndOffset;
+        B = tip - LineEndOffset;
+    }
+
+    auto to_box = [&box](glm::vec3 v) {
+        return glm::vec3(glm::dot(v, box.axis[0]), glm::dot(v, box.axis[1]), glm::dot(v, box.axis[2]));
+    };
+    *a = to_box(A - box.center);
+    *d = to_box(B - A);
+}
+
+static glm::vec3 box_to_world(OrientedBox const &box, glm::vec3 v) {
+    return box.center + v.x * box.axis[0] + v.y * box.axis[1] + v.z * box.axis[2];
+}
+
+// face whose outward normal best matches the (box frame) push direction:
+static SurfaceType obb_face(glm::vec3 local_normal) {
+    uint32_t best_axis = 0;
+    for (uint32_t i = 1; i < 3; i++) {
+        if (std::abs(local_normal[i]) > std::abs(local_normal[best_axis])) best_axis = i;
+    }
+    return obb_faces[best_axis][local_normal[best_axis] > 0.f ? 1 : 0];
+}
+
+// capsule_obb_collision with the segment already in the box frame (see capsule_segment_in_box)
+static bool capsule_obb_collision_local(glm::vec3 a, glm::vec3 d, float radius, OrientedBox const &box,
+                                        CollisionResult *result, CollisionDebug *debug) {
+    float t = closest_segment_parameter_to_box(a, d, box.half);
+    glm::vec3 seg_point = a + t * d;
+    glm::vec3 box_point = glm::clamp(seg_point, -box.half, box.half);
+    glm::vec3 diff = seg_point - box_point;
+    float dist2 = glm::dot(diff, diff);
+
+    if (dist2 >= radius * radius) {
+        return false;
+    }
+
+    glm::vec3 local_normal;
+    float depth;
+    if (dist2 > 1e-12f) {
+        // segment outside the box: push along the line between the closest points
+        float dist = std::sqrt(dist2);
+        local_normal = diff / dist;
+        depth = radius - dist;
+    } else {
+        // segment touches or passes through the box: push out through the face needing the least motion
+        glm::vec3 b = a + d;
+        depth = std::numeric_limits<float>::infinity();
+        local_normal = glm::vec3(0.f, 0.f, 1.f);
+        for (uint32_t i = 0; i < 3; i++) {
+            float out_pos = box.half[i] - std::min(a[i], b[i]);
+            float out_neg = std::max(a[i], b[i]) + box.half[i];
+            if (out_pos < depth) {
+                depth = out_pos;
+                local_normal = glm::vec3(0.f);
+                local_normal[i] = 1.f;
+            }
+            if (out_neg < depth) {
+                depth = out_neg;
+                local_normal = glm::vec3(0.f);
+                local_normal[i] = -1.f;
+            }
+        }
+        depth += radius;
+        // report the contact on the face being pushed out through:
+        for (uint32_t i = 0; i < 3; i++) {
+            if (local_normal[i] != 0.f) box_point[i] = local_normal[i] * box.half[i];
+        }
+    }
+
+    result->face = obb_face(local_normal);
+    result->normal = local_normal.x * box.axis[0] + local_normal.y * box.axis[1] + local_normal.z * box.axis[2];
+    result->depth = depth;
+    result->point = box_to_world(box, box_point);
+    if (debug) {
+        debug->segment_point = box_to_world(box, seg_point);
+        debug->surface_point = result->point;
     }
+    return true;
+}
 
+bool capsule_obb_collision(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box,
+                           CollisionResult *result, CollisionDebug *debug) {
+    glm::vec3 a, d;
+    capsule_segment_in_box(tip, base, radius, box, &a, &d);
+    return capsule_obb_collision_local(a, d, radius, box, result, debug);
+}
+
+bool capsule_obb_sweep(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, OrientedBox const &box,
+                       float *toi, CollisionResult *result) {
+    glm::vec3 a, d;
+    capsule_segment_in_box(tip, base, radius, box, &a, &d);
+    glm::vec3 m(glm::dot(motion, box.axis[0]), glm::dot(motion, box.axis[1]), glm::dot(motion, box.axis[2]));
+
+    // close enough to call it touching:
+    float const tolerance = std::max(1e-3f * radius, 1e-5f);
+
+    float t = 0.f;
+    for (uint32_t iter = 0; iter < 32; iter++) {
+        glm::vec3 at = a + t * m;
+        float s = closest_segment_parameter_to_box(at, d, box.half);
+        glm::vec3 seg_point = at + s * d;
+        glm::vec3 box_point = glm::clamp(seg_point, -box.half, box.half);
+        glm::vec3 diff = seg_point - box_point;
+        float dist = std::sqrt(glm::dot(diff, diff));
+        float gap = dist - radius;
+
+        if (gap < 0.f && t == 0.f) {
+            // already overlapping: a hit only if the motion goes further in
+            if (!capsule_obb_collision_local(a, d, radius, box, result, nullptr)) return false;
+            if (glm::dot(motion, result->normal) >= 0.f) return false;
+            *toi = 0.f;
+            return true;
+        }
+
+        glm::vec3 local_normal = diff / dist;
+        // The plane through the closest points, facing along local_normal, separates the capsule from the
+        // box, so they can't touch before the capsule has moved 'gap' along it; step exactly that far.
+        float approach = -glm::dot(m, local_normal);
+        if (approach <= 0.f) return false; // sliding along or moving away
+
+        if (gap <= tolerance || iter == 31) {
+            *toi = t;
+            result->face = obb_face(local_normal);
+            result->normal = local_normal.x * box.axis[0] + local_normal.y * box.axis[1] + local_normal.z * box.axis[2];
+            result->depth = std::max(radius - dist, 0.f);
+            result->point = box_to_world(box, box_point);
+            return true;
+        }
+
+        t += gap / approach;
+        if (t > 1.f) return false;
+    }
     return false;
 }
 
+bool ray_obb_intersection(glm::vec3 origin, glm::vec3 dir, float max_t, OrientedBox const &box, float *t) {
+    // slab test in the box frame:
+    glm::vec3 o = origin - box.center;
+    float enter = -std::numeric_limits<float>::infinity();
+    float exit = std::numeric_limits<float>::infinity();
+    for (uint32_t i = 0; i < 3; i++) {
+        float oi = glm::dot(o, box.axis[i]);
+        float di = glm::dot(dir, box.axis[i]);
+        if (std::abs(di) < 1e-8f) {
+            if (std::abs(oi) > box.half[i]) return false; // parallel to the slab and outside it
+            continue;
+        }
+        float t0 = (-box.half[i] - oi) / di;
+        float t1 = ( box.half[i] - oi) / di;
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+        if (enter > exit) return false;
+    }
+    float hit = (enter >= 0.f ? enter : exit);
+    if (hit < 0.f || hit > max_t) return false;
+    *t = hit;
+    return true;
+}
+
+// Single-face version of capsule_obb_collision. If the whole segment a + t * d lies in the face's
+// Voronoi region (outside its plane, inside the other two slabs), the closest box points are on
+// that face and the answer is exact; '*hit' then holds it and this returns true. Otherwise returns
+// false and the caller has to run the full test.
+static bool capsule_obb_face_collision(glm::vec3 a, glm::vec3 d, float radius, OrientedBox const &box,
+                                       uint32_t axis, float sign, bool *hit, CollisionResult *result, CollisionDebug *debug) {
+    glm::vec3 b = a + d;
+    for (uint32_t i = 0; i < 3; i++) {
+        if (i == axis) {
+            if (sign * a[i] < box.half[i] || sign * b[i] < box.half[i]) return false;
+        } else {
+            if (std::abs(a[i]) > box.half[i] || std::abs(b[i]) > box.half[i]) return false;
+        }
+    }
+
+    // height above the face is linear along the segment, so the closest point is an end:
+    glm::vec3 seg_point = (sign * b[axis] < sign * a[axis] ? b : a);
+    float dist = sign * seg_point[axis] - box.half[axis];
+    *hit = (dist * dist < radius * radius);
+    if (!*hit) return true;
+
+    glm::vec3 box_point = seg_point;
+    box_point[axis] = sign * box.half[axis];
+    result->face = obb_faces[axis][sign > 0.f ? 1 : 0];
+    result->normal = sign * box.axis[axis];
+    result->depth = radius - dist;
+    result->point = box_to_world(box, box_point);
+    if (debug) {
+        debug->segment_point = box_to_world(box, seg_point);
+        debug->surface_point = result->point;
+    }
+    return true;
+}
+
+void ContactCache::next_frame(uint32_t max_age) {
+    frame++;
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (frame - it->second.frame > max_age) it = entries.erase(it);
+        else ++it;
+    }
+}
+
+bool capsule_obb_collision(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box,
+                           ContactCache *cache, uint32_t collider_id, uint32_t object_id,
+                           CollisionResult *result, CollisionDebug *debug) {
+    glm::vec3 a, d;
+    capsule_segment_in_box(tip, base, radius, box, &a, &d);
+
+    uint64_t key = (uint64_t(collider_id) << 32) | uint64_t(object_id);
+    auto found = cache->entries.find(key);
+    if (found != cache->entries.end()) {
+        ContactCache::Entry &entry = found->second;
+        bool hit;
+        if (capsule_obb_face_collision(a, d, radius, box, entry.axis, float(entry.sign), &hit, result, debug)) {
+            entry.frame = cache->frame;
+            cache->face_tests++;
+            return hit;
+        }
+    }
+
+    cache->full_tests++;
+    if (!capsule_obb_collision_local(a, d, radius, box, result, debug)) return false;
+
+    // remember which face was hit for next time:
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        for (uint32_t side = 0; side < 2; side++) {
+            if (obb_faces[axis][side] != result->face) continue;
+            ContactCache::Entry &entry = cache->entries[key];
+            entry.axis = uint8_t(axis);
+            entry.sign = int8_t(side ? 1 : -1);
+            entry.frame = cache->frame;
+        }
+    }
+    return true;
+}
+
 // SOURCE: https://wickedengine.net/2020/04/26/capsule-collision-detection/
 bool capsule_capsule_collision(float a_radius, glm::vec3 a_tip, glm::vec3 a_base, 
                                float b_radius, glm::vec3 b_tip, glm::vec3 b_base) {
@@ -360,4 +984,36 @@ bool capsule_capsule_collision(float a_radius, glm::vec3 a_tip, glm::vec3 a_base
     float penetration_depth = a_radius + b_radius - len;
     
     return (penetration_depth > 0);
-}
\ No newline at end of file
+}
+
+uint32_t compound_bbox_contacts(CapsuleCollider const *capsules, uint32_t capsule_count, OrientedBox const &box, uint32_t object_id,
+                                std::vector<Contact> *contacts, ContactCache *cache, uint32_t collider_id, CollisionDebug *debug) {
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < capsule_count; i++) {
+        Contact contact;
+        CapsuleCollider const &capsule = capsules[i];
+        bool hit = (cache
+            ? capsule_obb_collision(capsule.tip, capsule.base, capsule.radius, box, cache, collider_id + i, object_id, &contact.result, debug)
+            : capsule_obb_collision(capsule.tip, capsule.base, capsule.radius, box, &contact.result, debug));
+        if (!hit) continue;
+        contact.result.object_id = object_id;
+        contact.capsule = i;
+        contact.up = is_almost_up_vec(contact.result.normal);
+        contacts->emplace_back(contact);
+        hits++;
+    }
+    return hits;
+}
+
+void sort_contacts(std::vector<Contact> *contacts) {
+    std::stable_sort(contacts->begin(), contacts->end(), [](Contact const &a, Contact const &b) {
+        return a.result.depth > b.result.depth;
+    });
+}
+
+int32_t primary_contact(std::vector<Contact> const &contacts) {
+    for (uint32_t i = 0; i < contacts.size(); i++) {
+        if (contacts[i].up) return int32_t(i);
+    }
+    return contacts.empty() ? -1 : 0;
+}
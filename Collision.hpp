@@ -1,3 +1,5 @@
+#pragma once
+
 /*
     ######################################################################## 
                                 Collision Handling
@@ -9,31 +11,158 @@
 
 */
 
-#include "RoomObject.hpp"
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
+
+enum SurfaceType {TOP, BOT, FRONT, BACK, LEFT, RIGHT};
+
+// What a narrowphase query found. Queries only write to the result (and optional debug context)
+// they are handed, so they can run concurrently.
+struct CollisionResult {
+    glm::vec3 point = glm::vec3(0.f);   // contact point on the other shape's surface
+    glm::vec3 normal = glm::vec3(0.f);  // points from the other shape toward the capsule / sphere
+    float depth = 0.f;
+    SurfaceType face = TOP;             // box queries only
+    uint32_t object_id = -1U;           // left for the caller to fill in (e.g. RoomObject::id)
+};
+
+// Optional per-query debug capture, e.g. for drawing the contact with DrawLines:
+struct CollisionDebug {
+    glm::vec3 segment_point = glm::vec3(0.f); // sphere center tested on the capsule segment
+    glm::vec3 surface_point = glm::vec3(0.f); // closest point on the other shape
+};
+
+// Structure-of-arrays batch of up to Width triangles, with unit face normals precomputed
+// so repeated queries against the same faces (e.g. a bbox) don't redo normalize(cross(...)).
+struct TriangleBatch {
+    enum : uint32_t { Width = 4 };
+    alignas(16) float p0x[Width], p0y[Width], p0z[Width];
+    alignas(16) float p1x[Width], p1y[Width], p1z[Width];
+    alignas(16) float p2x[Width], p2y[Width], p2z[Width];
+    alignas(16) float nx[Width], ny[Width], nz[Width];
+    uint32_t count = 0;
+
+    // append a triangle (winding p0, p1, p2 decides the normal, as in capsule_triangle_collision)
+    void push(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2);
+};
+
+// Box in its own frame: axis[0] points toward the LEFT face, axis[1] toward FRONT, axis[2] toward TOP
+// (matching the bbox corner order used by capsule_bbox_collision), half = half extents along each axis.
+struct OrientedBox {
+    glm::vec3 center = glm::vec3(0.f);
+    glm::vec3 axis[3] = {glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f)};
+    glm::vec3 half = glm::vec3(0.f);
+};
+
+// fits an OrientedBox to the eight bbox corners (flat or degenerate boxes get a zero half extent)
+OrientedBox make_oriented_box(glm::vec3 const *p);
+
+// Closed-form capsule vs oriented box: finds the closest points between the capsule segment and the
+// box, or the shallowest face to push out through when the segment is inside. pen_normal points from
+// the box toward the capsule; result->face is the face whose normal best matches it.
+bool capsule_obb_collision(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box,
+                           CollisionResult *result, CollisionDebug *debug = nullptr);
+
+// Swept capsule vs oriented box: moves the capsule by t * motion, t in [0,1], and finds the first t at
+// which it touches the box (conservative advancement, so it can't step through thin boxes). On a hit,
+// *toi = t and result holds the touching contact. A capsule that already overlaps the box hits at
+// t = 0 only if the motion pushes it further in.
+bool capsule_obb_sweep(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, OrientedBox const &box,
+                       float *toi, CollisionResult *result);
+
+// Ray origin + t * dir vs oriented box: *t is the first t >= 0 at which the ray crosses the box surface
+// (its exit if the origin is inside), as long as it is no more than max_t.
+bool ray_obb_intersection(glm::vec3 origin, glm::vec3 dir, float max_t, OrientedBox const &box, float *t);
+
+// Remembers, per (collider, object) pair, which box face the last hit was on, so the next query
+// can usually be answered by that one face (e.g. the cat standing on a counter frame after frame).
+struct ContactCache {
+    struct Entry {
+        uint8_t axis = 0;  // OrientedBox axis of the face
+        int8_t sign = 1;   // which side of the box along that axis
+        uint32_t frame = 0; // last frame the entry was used
+    };
+    std::unordered_map<uint64_t, Entry> entries; // key: collider id << 32 | object id
+    uint32_t frame = 0;
+
+    // stats: queries answered by the cached face vs. by the full test
+    uint32_t face_tests = 0;
+    uint32_t full_tests = 0;
+
+    // call once per frame; forgets pairs that have not been queried for 'max_age' frames
+    void next_frame(uint32_t max_age = 30);
+};
+
+// capsule_obb_collision that tries the face cached for (collider_id, object_id) first and only runs the
+// full test when the capsule is not squarely over that face; gives the same answer as the full test.
+bool capsule_obb_collision(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box,
+                           ContactCache *cache, uint32_t collider_id, uint32_t object_id,
+                           CollisionResult *result, CollisionDebug *debug = nullptr);
+
+// builds the twelve bbox triangles (two per face, faces ordered TOP, BOT, LEFT, RIGHT, FRONT, BACK) into three batches
+void make_bbox_batches(glm::vec3 const *p, TriangleBatch batches[3]);
 
 glm::vec3 closest_point_on_line_segment(glm::vec3 A, glm::vec3 B, glm::vec3 Point);
 bool is_almost_up_vec(glm::vec3 &v);
 bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
                                 glm::vec3 *pen_normal, float *pen_depth);
+bool sphere_triangle_collision(glm::vec3 center, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+                               CollisionResult *result);
 
 bool parallel_capsule_triangle_collision(glm::vec3 A, glm::vec3 B, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, float radius, 
                                          glm::vec3 *pen_normal, float *pen_depth);
 
 bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
                                 glm::vec3 *pen_normal, float *pen_depth);
+bool capsule_triangle_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 p0, glm::vec3 p1, glm::vec3 p2,
+                                CollisionResult *result, CollisionDebug *debug = nullptr);
 
 bool capsule_rectagle_collision(glm::vec3 tip, glm::vec3 base, float radius, 
                                 glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, 
                                 glm::vec3 *pen_normal, float *pen_depth);
 
-bool capsule_bbox_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 *p, 
+bool capsule_bbox_collision(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 const *p, 
                                 SurfaceType *surface, glm::vec3 *pen_normal, float *pen_depth);
+// same, but against a box prebuilt with make_oriented_box:
+bool capsule_bbox_collision(glm::vec3 tip, glm::vec3 base, float radius, OrientedBox const &box, 
+                                CollisionResult *result, CollisionDebug *debug = nullptr);
+
+// Tests one capsule against every triangle in 'batches' and reports the deepest contact
+// ('hit_index' = batch * TriangleBatch::Width + lane). Uses SSE when available; the
+// _scalar version is the per-triangle reference it must agree with.
+bool capsule_triangle_batch_collision(glm::vec3 tip, glm::vec3 base, float radius, 
+                                      TriangleBatch const *batches, uint32_t batch_count,
+                                      CollisionResult *result, uint32_t *hit_index, CollisionDebug *debug = nullptr);
+bool capsule_triangle_batch_collision_scalar(glm::vec3 tip, glm::vec3 base, float radius, 
+                                             TriangleBatch const *batches, uint32_t batch_count,
+                                             CollisionResult *result, uint32_t *hit_index, CollisionDebug *debug = nullptr);
 
 bool capsule_capsule_collision(float a_radius, glm::vec3 a_tip, glm::vec3 a_base, 
                                float b_radius, glm::vec3 b_tip, glm::vec3 b_base);
 
-extern glm::vec3 center_;
-extern glm::vec3 tri_point_;
-extern bool is_side_;
\ No newline at end of file
+// ----- Compound colliders (several capsules moving as one body, e.g. the cat's front and middle) -----
+struct CapsuleCollider {
+    glm::vec3 tip = glm::vec3(0.f);
+    glm::vec3 base = glm::vec3(0.f);
+    float radius = 0.f;
+};
+
+struct Contact {
+    CollisionResult result;
+    uint32_t capsule = 0; // index into the compound collider
+    bool up = false;      // result.normal is (almost) straight up, see is_almost_up_vec
+};
+
+// Tests every capsule against one box and appends a Contact (tagged with object_id) per hit; returns the hit count.
+// With a cache, capsule i is cached as collider (collider_id + i).
+uint32_t compound_bbox_contacts(CapsuleCollider const *capsules, uint32_t capsule_count, OrientedBox const &box, uint32_t object_id,
+                                std::vector<Contact> *contacts, ContactCache *cache = nullptr, uint32_t collider_id = 0,
+                                CollisionDebug *debug = nullptr);
+// Deepest first; stable, so equal depths keep the order they were found in.
+void sort_contacts(std::vector<Contact> *contacts);
+// The contact to resolve motion against (contacts sorted by sort_contacts): the deepest up-facing one
+// if there is one, else the deepest. -1 if empty.
+int32_t primary_contact(std::vector<Contact> const &contacts);
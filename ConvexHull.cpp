@@ -0,0 +1,593 @@
+#include "ConvexHull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ----- Hull construction -----
+
+namespace {
+    struct HullFace {
+        uint32_t v[3];
+        glm::vec3 n; // outward unit normal
+        float d;     // plane offset, dot(n, x) == d on the face
+    };
+}
+
+bool ConvexHull::build(glm::vec3 const *positions, uint32_t count, glm::mat4x3 const &to_world) {
+    vertices.clear();
+    face_count = 0;
+    bounds = AABB();
+
+    std::vector<glm::vec3> points;
+    points.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        points.emplace_back(to_world * glm::vec4(positions[i], 1.0f));
+    }
+    // triangle lists repeat every shared vertex; drop exact duplicates:
+    auto less = [](glm::vec3 const &a, glm::vec3 const &b) {
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        return a.z < b.z;
+    };
+    std::sort(points.begin(), points.end(), less);
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 4) return false;
+
+    AABB box = AABB::from_points(points.data(), uint32_t(points.size()));
+    glm::vec3 extent = box.max - box.min;
+    float scale = std::max({extent.x, extent.y, extent.z});
+    if (!(scale > 0.f)) return false;
+    float const eps = 1e-5f * scale;
+
+    // starting tetrahedron from extreme points:
+    uint32_t t[4] = {0, 0, 0, 0}; // points are sorted, so points[0] has the smallest x
+    float best = 0.f;
+    for (uint32_t i = 0; i < points.size(); i++) {
+        glm::vec3 d = points[i] - points[t[0]];
+        if (glm::dot(d, d) > best) { best = glm::dot(d, d); t[1] = i; }
+    }
+    if (std::sqrt(best) <= eps) return false;
+    glm::vec3 line = glm::normalize(points[t[1]] - points[t[0]]);
+    best = 0.f;
+    for (uint32_t i = 0; i < points.size(); i++) {
+        glm::vec3 d = points[i] - points[t[0]];
+        glm::vec3 off = d - glm::dot(d, line) * line;
+        if (glm::dot(off, off) > best) { best = glm::dot(off, off); t[2] = i; }
+    }
+    if (std::sqrt(best) <= eps) return false;
+    glm::vec3 plane = glm::normalize(glm::cross(points[t[1]] - points[t[0]], points[t[2]] - points[t[0]]));
+    best = 0.f;
+    for (uint32_t i = 0; i < points.size(); i++) {
+        float d = std::abs(glm::dot(points[i] - points[t[0]], plane));
+        if (d > best) { best = d; t[3] = i; }
+    }
+    if (best <= eps) return false; // flat, e.g. a single quad
+
+    glm::vec3 inside = 0.25f * (points[t[0]] + points[t[1]] + points[t[2]] + points[t[3]]);
+    std::vector<HullFace> faces;
+    auto add_face = [&](uint32_t a, uint32_t b, uint32_t c) {
+        HullFace face;
+        face.v[0] = a; face.v[1] = b; face.v[2] = c;
+        face.n = glm::cross(points[b] - points[a], points[c] - points[a]);
+        float len = glm::length(face.n);
+        face.n = (len > 0.f ? face.n / len : glm::vec3(0.f));
+        if (glm::dot(face.n, points[a] - inside) < 0.f) {
+            std::swap(face.v[1], face.v[2]);
+            face.n = -face.n;
+        }
+        face.d = glm::dot(face.n, points[a]);
+        faces.emplace_back(face);
+    };
+    add_face(t[0], t[1], t[2]);
+    add_face(t[0], t[1], t[3]);
+    add_face(t[0], t[2], t[3]);
+    add_face(t[1], t[2], t[3]);
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<HullFace> kept;
+    for (uint32_t i = 0; i < points.size(); i++) {
+        if (i == t[0] || i == t[1] || i == t[2] || i == t[3]) continue;
+        glm::vec3 p = points[i];
+
+        // faces that can see p get replaced by a fan from p to their outline (the horizon):
+        edges.clear();
+        kept.clear();
+        for (auto const &face : faces) {
+            if (glm::dot(face.n, p) - face.d > eps) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    edges.emplace_back(face.v[k], face.v[(k + 1) % 3]);
+                }
+            } else {
+                kept.emplace_back(face);
+            }
+        }
+        if (edges.empty()) continue; // inside the hull so far
+
+        faces.swap(kept);
+        for (auto const &edge : edges) {
+            // an edge shared by two visible faces appears once in each direction and is not on the horizon:
+            bool shared = std::find(edges.begin(), edges.end(), std::make_pair(edge.second, edge.first)) != edges.end();
+            if (!shared) add_face(edge.first, edge.second, i);
+        }
+    }
+
+    std::vector<bool> used(points.size(), false);
+    for (auto const &face : faces) {
+        for (uint32_t k = 0; k < 3; k++) used[face.v[k]] = true;
+    }
+    for (uint32_t i = 0; i < points.size(); i++) {
+        if (used[i]) vertices.emplace_back(points[i]);
+    }
+    face_count = uint32_t(faces.size());
+    bounds = AABB::from_points(vertices.data(), uint32_t(vertices.size()));
+    return true;
+}
+
+glm::vec3 ConvexHull::support(glm::vec3 dir) const {
+    uint32_t best = 0;
+    float best_dot = -std::numeric_limits<float>::infinity();
+    for (uint32_t i = 0; i < vertices.size(); i++) {
+        float d = glm::dot(vertices[i], dir);
+        if (d > best_dot) {
+            best_dot = d;
+            best = i;
+        }
+    }
+    return vertices[best];
+}
+
+// ----- GJK -----
+// Works on the Minkowski difference A - B: the shapes overlap iff it contains the origin, and its point
+// closest to the origin is the difference of the closest points of A and B.
+
+namespace {
+    struct SupportPoint {
+        glm::vec3 w; // a - b
+        glm::vec3 a, b;
+    };
+
+    struct Simplex {
+        SupportPoint p[4];
+        float bary[4]; // weights of the point closest to the origin
+        uint32_t count = 0;
+    };
+}
+
+// keeps the simplex feature (vertex or edge of a, b) closest to the origin and returns that closest point
+static glm::vec3 reduce_segment(SupportPoint const &a, SupportPoint const &b, Simplex *out) {
+    glm::vec3 ab = b.w - a.w;
+    float len2 = glm::dot(ab, ab);
+    float t = (len2 > 0.f ? -glm::dot(a.w, ab) / len2 : 0.f);
+    if (t <= 0.f) {
+        out->p[0] = a; out->bary[0] = 1.f; out->count = 1;
+        return a.w;
+    }
+    if (t >= 1.f) {
+        out->p[0] = b; out->bary[0] = 1.f; out->count = 1;
+        return b.w;
+    }
+    out->p[0] = a; out->p[1] = b;
+    out->bary[0] = 1.f - t; out->bary[1] = t;
+    out->count = 2;
+    return a.w + t * ab;
+}
+
+// same for a triangle (closest point by Voronoi regions, as in Ericson's Real-Time Collision Detection 5.1.5)
+static glm::vec3 reduce_triangle(SupportPoint const &a, SupportPoint const &b, SupportPoint const &c, Simplex *out) {
+    glm::vec3 ab = b.w - a.w, ac = c.w - a.w;
+    float d1 = -glm::dot(ab, a.w), d2 = -glm::dot(ac, a.w);
+    if (d1 <= 0.f && d2 <= 0.f) return reduce_segment(a, a, out);
+
+    float d3 = -glm::dot(ab, b.w), d4 = -glm::dot(ac, b.w);
+    if (d3 >= 0.f && d4 <= d3) return reduce_segment(b, b, out);
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) return reduce_segment(a, b, out);
+
+    float d5 = -glm::dot(ab, c.w), d6 = -glm::dot(ac, c.w);
+    if (d6 >= 0.f && d5 <= d6) return reduce_segment(c, c, out);
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) return reduce_segment(a, c, out);
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) return reduce_segment(b, c, out);
+
+    float denom = va + vb + vc;
+    if (!(denom > 0.f)) return reduce_segment(a, b, out); // degenerate triangle
+    float v = vb / denom, w = vc / denom;
+    out->p[0] = a; out->p[1] = b; out->p[2] = c;
+    out->bary[0] = 1.f - v - w; out->bary[1] = v; out->bary[2] = w;
+    out->count = 3;
+    return a.w + v * ab + w * ac;
+}
+
+// replaces the simplex with its feature closest to the origin; a tetrahedron containing the origin stays whole
+static glm::vec3 reduce_simplex(Simplex *s) {
+    if (s->count == 1) { s->bary[0] = 1.f; return s->p[0].w; }
+    Simplex in = *s;
+    if (s->count == 2) return reduce_segment(in.p[0], in.p[1], s);
+    if (s->count == 3) return reduce_triangle(in.p[0], in.p[1], in.p[2], s);
+
+    // tetrahedron: the origin is enclosed if it is on the inner side of every face; otherwise the closest
+    // point is on one of the faces. A (nearly) flat tetrahedron can't enclose anything, and its side tests
+    // are rounding noise, so it always goes the face route.
+    static uint32_t const face[4][4] = {{0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+    float longest2 = 0.f;
+    for (uint32_t i = 1; i < 4; i++) {
+        glm::vec3 e = in.p[i].w - in.p[0].w;
+        longest2 = std::max(longest2, glm::dot(e, e));
+    }
+    float volume = glm::dot(glm::cross(in.p[1].w - in.p[0].w, in.p[2].w - in.p[0].w), in.p[3].w - in.p[0].w);
+    bool flat = std::abs(volume) <= 1e-5f * longest2 * std::sqrt(longest2);
+    if (!flat) {
+        bool inside = true;
+        for (auto const &f : face) {
+            SupportPoint const &a = in.p[f[0]], &b = in.p[f[1]], &c = in.p[f[2]], &d = in.p[f[3]];
+            glm::vec3 n = glm::cross(b.w - a.w, c.w - a.w);
+            if (-glm::dot(n, a.w) * glm::dot(n, d.w - a.w) < 0.f) inside = false;
+        }
+        if (inside) return glm::vec3(0.f);
+    }
+
+    glm::vec3 best = glm::vec3(0.f);
+    float best_dist2 = std::numeric_limits<float>::infinity();
+    for (auto const &f : face) {
+        Simplex candidate;
+        glm::vec3 q = reduce_triangle(in.p[f[0]], in.p[f[1]], in.p[f[2]], &candidate);
+        if (glm::dot(q, q) < best_dist2) {
+            best_dist2 = glm::dot(q, q);
+            best = q;
+            *s = candidate;
+        }
+    }
+    return best;
+}
+
+// Runs GJK on A - B; returns true if the shapes overlap. Otherwise *a_point, *b_point are the closest points.
+template<typename SupportA, typename SupportB>
+static bool gjk(SupportA const &support_a, SupportB const &support_b, glm::vec3 first_dir,
+                Simplex *simplex, glm::vec3 *a_point, glm::vec3 *b_point) {
+    auto support = [&](glm::vec3 d) {
+        SupportPoint s;
+        s.a = support_a(d);
+        s.b = support_b(-d);
+        s.w = s.a - s.b;
+        return s;
+    };
+
+    simplex->p[0] = support(first_dir);
+    simplex->bary[0] = 1.f;
+    simplex->count = 1;
+    glm::vec3 v = simplex->p[0].w;
+
+    for (uint32_t iter = 0; iter < 64; iter++) {
+        float vv = glm::dot(v, v);
+        if (vv <= 1e-12f) return true;
+
+        SupportPoint s = support(-v);
+        // no point further toward the origin than the current closest point, so it is the closest point:
+        if (vv - glm::dot(v, s.w) <= 1e-6f * vv) break;
+        bool duplicate = false;
+        for (uint32_t i = 0; i < simplex->count; i++) {
+            if (simplex->p[i].w == s.w) duplicate = true;
+        }
+        if (duplicate) break;
+
+        simplex->p[simplex->count++] = s;
+        glm::vec3 next = reduce_simplex(simplex);
+        if (simplex->count == 4) return true; // origin enclosed
+        if (glm::dot(next, next) >= vv) {
+            v = next;
+            break; // rounding; no more progress to make
+        }
+        v = next;
+    }
+    if (glm::dot(v, v) <= 1e-12f) return true;
+
+    *a_point = glm::vec3(0.f);
+    *b_point = glm::vec3(0.f);
+    for (uint32_t i = 0; i < simplex->count; i++) {
+        *a_point += simplex->bary[i] * simplex->p[i].a;
+        *b_point += simplex->bary[i] * simplex->p[i].b;
+    }
+    return false;
+}
+
+// ----- EPA -----
+// Grows GJK's final simplex into a polytope inside A - B until its face nearest the origin is on the
+// boundary of A - B: that face's normal and distance are the penetration normal and depth.
+
+template<typename SupportA, typename SupportB>
+static bool epa(SupportA const &support_a, SupportB const &support_b, Simplex const &simplex,
+                glm::vec3 *normal, float *depth, glm::vec3 *a_point) {
+    auto support = [&](glm::vec3 d) {
+        SupportPoint s;
+        s.a = support_a(d);
+        s.b = support_b(-d);
+        s.w = s.a - s.b;
+        return s;
+    };
+
+    enum : uint32_t { MaxVerts = 64, MaxFaces = 128, MaxEdges = 3 * MaxFaces };
+    SupportPoint verts[MaxVerts];
+    uint32_t vert_count = 0;
+    for (uint32_t i = 0; i < simplex.count; i++) verts[vert_count++] = simplex.p[i];
+
+    // blow a smaller simplex up into a tetrahedron:
+    float const eps = 1e-6f;
+    auto try_add = [&](glm::vec3 dir) {
+        SupportPoint s = support(dir);
+        for (uint32_t i = 0; i < vert_count; i++) {
+            if (glm::length(s.w - verts[i].w) <= eps) return false;
+        }
+        if (vert_count == 2) {
+            glm::vec3 d = glm::normalize(verts[1].w - verts[0].w);
+            glm::vec3 off = (s.w - verts[0].w) - glm::dot(s.w - verts[0].w, d) * d;
+            if (glm::length(off) <= eps) return false;
+        } else if (vert_count == 3) {
+            glm::vec3 n = glm::normalize(glm::cross(verts[1].w - verts[0].w, verts[2].w - verts[0].w));
+            if (std::abs(glm::dot(s.w - verts[0].w, n)) <= eps) return false;
+        }
+        verts[vert_count++] = s;
+        return true;
+    };
+    glm::vec3 const axes[3] = {glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f)};
+    if (vert_count == 1) {
+        for (uint32_t i = 0; i < 6 && vert_count == 1; i++) try_add((i & 1 ? -1.f : 1.f) * axes[i / 2]);
+    }
+    if (vert_count == 2) {
+        glm::vec3 d = verts[1].w - verts[0].w;
+        uint32_t least = 0;
+        for (uint32_t i = 1; i < 3; i++) {
+            if (std::abs(d[i]) < std::abs(d[least])) least = i;
+        }
+        glm::vec3 e1 = glm::cross(d, axes[least]);
+        glm::vec3 e2 = glm::cross(d, e1);
+        glm::vec3 const dirs[4] = {e1, -e1, e2, -e2};
+        for (uint32_t i = 0; i < 4 && vert_count == 2; i++) try_add(dirs[i]);
+    }
+    if (vert_count == 3) {
+        glm::vec3 n = glm::cross(verts[1].w - verts[0].w, verts[2].w - verts[0].w);
+        if (!try_add(n)) try_add(-n);
+    }
+    if (vert_count < 4) return false;
+
+    struct Face {
+        uint32_t v[3];
+        glm::vec3 n;
+        float d;
+    };
+    Face faces[MaxFaces];
+    uint32_t face_count = 0;
+    glm::vec3 inside = 0.25f * (verts[0].w + verts[1].w + verts[2].w + verts[3].w);
+    auto add_face = [&](uint32_t a, uint32_t b, uint32_t c) {
+        if (face_count == MaxFaces) return false;
+        Face &face = faces[face_count];
+        face.v[0] = a; face.v[1] = b; face.v[2] = c;
+        glm::vec3 n = glm::cross(verts[b].w - verts[a].w, verts[c].w - verts[a].w);
+        float len = glm::length(n);
+        if (!(len > 0.f)) return true; // sliver; its neighbours cover it
+        n /= len;
+        if (glm::dot(n, verts[a].w - inside) < 0.f) {
+            std::swap(face.v[1], face.v[2]);
+            n = -n;
+        }
+        face.n = n;
+        face.d = glm::dot(n, verts[face.v[0]].w);
+        face_count++;
+        return true;
+    };
+    add_face(0, 1, 2);
+    add_face(0, 1, 3);
+    add_face(0, 2, 3);
+    add_face(1, 2, 3);
+
+    auto closest_face = [&]() {
+        uint32_t closest = 0;
+        for (uint32_t i = 1; i < face_count; i++) {
+            if (faces[i].d < faces[closest].d) closest = i;
+        }
+        return closest;
+    };
+    for (uint32_t iter = 0; iter < 32; iter++) {
+        Face const &face = faces[closest_face()];
+        SupportPoint s = support(face.n);
+        if (glm::dot(s.w, face.n) - face.d <= 1e-4f || vert_count == MaxVerts) break; // on the boundary
+
+        uint32_t added = vert_count;
+        verts[vert_count++] = s;
+
+        // remove faces the new point can see, keeping their outline:
+        uint32_t edges[MaxEdges][2];
+        uint32_t edge_count = 0;
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < face_count; i++) {
+            if (glm::dot(faces[i].n, s.w) - faces[i].d > 0.f) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    uint32_t a = faces[i].v[k], b = faces[i].v[(k + 1) % 3];
+                    bool removed = false;
+                    for (uint32_t e = 0; e < edge_count; e++) {
+                        if (edges[e][0] == b && edges[e][1] == a) {
+                            edges[e][0] = edges[edge_count - 1][0];
+                            edges[e][1] = edges[edge_count - 1][1];
+                            edge_count--;
+                            removed = true;
+                            break;
+                        }
+                    }
+                    if (!removed && edge_count < MaxEdges) {
+                        edges[edge_count][0] = a;
+                        edges[edge_count][1] = b;
+                        edge_count++;
+                    }
+                }
+            } else {
+                faces[kept++] = faces[i];
+            }
+        }
+        face_count = kept;
+        for (uint32_t e = 0; e < edge_count; e++) {
+            if (!add_face(edges[e][0], edges[e][1], added)) break;
+        }
+        if (face_count == 0) return false;
+    }
+
+    // picked again: if the loop ran out of iterations, the last one expanded the polytope after its pick
+    Face const &face = faces[closest_face()];
+    *normal = face.n;
+    *depth = std::max(face.d, 0.f);
+
+    // contact: the origin projected onto the face, as barycentric weights of its corners
+    glm::vec3 p = face.n * face.d;
+    glm::vec3 a = verts[face.v[0]].w, b = verts[face.v[1]].w, c = verts[face.v[2]].w;
+    glm::vec3 v0 = b - a, v1 = c - a, v2 = p - a;
+    float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+    float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+    float denom = d00 * d11 - d01 * d01;
+    float v = 1.f / 3.f, w = 1.f / 3.f;
+    if (denom != 0.f) {
+        v = (d11 * d20 - d01 * d21) / denom;
+        w = (d00 * d21 - d01 * d20) / denom;
+    }
+    *a_point = (1.f - v - w) * verts[face.v[0]].a + v * verts[face.v[1]].a + w * verts[face.v[2]].a;
+    return true;
+}
+
+// ----- Queries -----
+
+// capsule segment (line endpoints A, B like in capsule_triangle_collision)
+static void capsule_segment(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 *A, glm::vec3 *B) {
+    *A = base;
+    *B = tip;
+    glm::vec3 axis = tip - base;
+    if (glm::dot(axis, axis) > 0.f) {
+        glm::vec3 LineEndOffset = glm::normalize(axis) * radius;
+        *A = base + LineEndOffset;
+        *B = tip - LineEndOffset;
+    }
+}
+
+// segment A, B vs hull; the hull is shape 'a' of the Minkowski difference
+static bool segment_hull_collision(glm::vec3 A, glm::vec3 B, float radius, ConvexHull const &hull, CollisionResult *result) {
+    if (hull.vertices.empty()) return false;
+    auto support_hull = [&hull](glm::vec3 d) { return hull.support(d); };
+    auto support_segment = [A, B](glm::vec3 d) { return glm::dot(d, A) >= glm::dot(d, B) ? A : B; };
+
+    Simplex simplex;
+    glm::vec3 hull_point, segment_point;
+    glm::vec3 first_dir = 0.5f * (A + B) - 0.5f * (hull.bounds.min + hull.bounds.max);
+    if (!gjk(support_hull, support_segment, -first_dir, &simplex, &hull_point, &segment_point)) {
+        glm::vec3 diff = segment_point - hull_point;
+        float dist2 = glm::dot(diff, diff);
+        if (dist2 >= radius * radius) return false;
+        float dist = std::sqrt(dist2);
+        result->normal = (dist > 0.f ? diff / dist : glm::vec3(0.f, 0.f, 1.f));
+        result->depth = radius - dist;
+        result->point = hull_point;
+        return true;
+    }
+
+    glm::vec3 normal;
+    float depth;
+    if (!epa(support_hull, support_segment, simplex, &normal, &depth, &hull_point)) {
+        // touching exactly on the surface with nothing to expand; push straight out from the middle
+        normal = first_dir;
+        float len = glm::length(normal);
+        normal = (len > 0.f ? normal / len : glm::vec3(0.f, 0.f, 1.f));
+        depth = 0.f;
+        hull_point = 0.5f * (A + B);
+    }
+    result->normal = normal;
+    result->depth = depth + radius;
+    result->point = hull_point;
+    return true;
+}
+
+bool capsule_hull_collision(glm::vec3 tip, glm::vec3 base, float radius, ConvexHull const &hull, CollisionResult *result) {
+    glm::vec3 A, B;
+    capsule_segment(tip, base, radius, &A, &B);
+    return segment_hull_collision(A, B, radius, hull, result);
+}
+
+bool capsule_hull_sweep(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, ConvexHull const &hull,
+                        float *toi, CollisionResult *result) {
+    if (hull.vertices.empty()) return false;
+    glm::vec3 A, B;
+    capsule_segment(tip, base, radius, &A, &B);
+    auto support_hull = [&hull](glm::vec3 d) { return hull.support(d); };
+
+    float const tolerance = std::max(1e-3f * radius, 1e-5f);
+    float t = 0.f;
+    for (uint32_t iter = 0; iter < 32; iter++) {
+        glm::vec3 a = A + t * motion, b = B + t * motion;
+        auto support_segment = [a, b](glm::vec3 d) { return glm::dot(d, a) >= glm::dot(d, b) ? a : b; };
+
+        Simplex simplex;
+        glm::vec3 hull_point, segment_point;
+        glm::vec3 first_dir = 0.5f * (a + b) - 0.5f * (hull.bounds.min + hull.bounds.max);
+        bool overlap = gjk(support_hull, support_segment, -first_dir, &simplex, &hull_point, &segment_point);
+        glm::vec3 diff = segment_point - hull_point;
+        float dist = std::sqrt(glm::dot(diff, diff));
+        if (overlap || dist < radius) {
+            // already overlapping at the start (or rounding let us step in): a hit if moving further in
+            if (!segment_hull_collision(a, b, radius, hull, result)) return false;
+            if (t == 0.f && glm::dot(motion, result->normal) >= 0.f) return false;
+            *toi = t;
+            return true;
+        }
+
+        glm::vec3 n = diff / dist;
+        // same separating-plane step as capsule_obb_sweep:
+        float approach = -glm::dot(motion, n);
+        if (approach <= 0.f) return false;
+        float gap = dist - radius;
+        if (gap <= tolerance || iter == 31) {
+            *toi = t;
+            result->normal = n;
+            result->depth = 0.f;
+            result->point = hull_point;
+            return true;
+        }
+        t += gap / approach;
+        if (t > 1.f) return false;
+    }
+    return false;
+}
+
+bool hull_hull_collision(ConvexHull const &a, ConvexHull const &b, CollisionResult *result) {
+    if (a.vertices.empty() || b.vertices.empty()) return false;
+    if (!a.bounds.overlaps(b.bounds)) return false;
+    auto support_a = [&a](glm::vec3 d) { return a.support(d); };
+    auto support_b = [&b](glm::vec3 d) { return b.support(d); };
+
+    Simplex simplex;
+    glm::vec3 a_point, b_point;
+    glm::vec3 first_dir = 0.5f * (b.bounds.min + b.bounds.max) - 0.5f * (a.bounds.min + a.bounds.max);
+    if (!gjk(support_a, support_b, -first_dir, &simplex, &a_point, &b_point)) return false;
+
+    glm::vec3 normal;
+    float depth;
+    if (!epa(support_a, support_b, simplex, &normal, &depth, &a_point)) return false; // just touching
+    result->normal = normal;
+    result->depth = depth;
+    result->point = a_point;
+    return true;
+}
+
+uint32_t compound_hull_contacts(CapsuleCollider const *capsules, uint32_t capsule_count, ConvexHull const &hull,
+                                uint32_t object_id, std::vector<Contact> *contacts) {
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < capsule_count; i++) {
+        Contact contact;
+        CapsuleCollider const &capsule = capsules[i];
+        if (!capsule_hull_collision(capsule.tip, capsule.base, capsule.radius, hull, &contact.result)) continue;
+        contact.result.object_id = object_id;
+        contact.capsule = i;
+        contact.up = is_almost_up_vec(contact.result.normal);
+        contacts->emplace_back(contact);
+        hits++;
+    }
+    return hits;
+}
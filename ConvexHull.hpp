@@ -0,0 +1,43 @@
+#pragma once
+
+// Convex-hull collider: tighter than a bbox for most furniture, far cheaper than the full triangle mesh.
+//
+// The hull is built once from a mesh's vertices (incremental quickhull) and queried with GJK, which finds
+// the closest points between two convex shapes using only their support functions; when the shapes
+// overlap, EPA expands GJK's final simplex to find the penetration normal and depth. Cost per pair grows
+// with the hull's vertex count, not the mesh's triangle count.
+
+#include "AABBTree.hpp"
+#include "Collision.hpp"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct ConvexHull {
+    // hull of a GL_TRIANGLES vertex range (duplicate vertices are fine) placed in the world by 'to_world';
+    // returns false (and leaves the hull empty) if the points are flat or too few. Rebuild if the object moves.
+    bool build(glm::vec3 const *positions, uint32_t count, glm::mat4x3 const &to_world);
+
+    // farthest hull vertex along 'dir':
+    glm::vec3 support(glm::vec3 dir) const;
+
+    std::vector<glm::vec3> vertices; // only the vertices on the hull
+    uint32_t face_count = 0;
+    AABB bounds;
+};
+
+// Capsule vs hull: closest points by GJK when apart, EPA when the capsule's segment is inside the hull.
+// result->normal points from the hull toward the capsule, result->point is on the hull (result->face is left as is).
+bool capsule_hull_collision(glm::vec3 tip, glm::vec3 base, float radius, ConvexHull const &hull, CollisionResult *result);
+
+// capsule_obb_sweep for hulls (conservative advancement on the GJK distance).
+bool capsule_hull_sweep(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, ConvexHull const &hull,
+                        float *toi, CollisionResult *result);
+
+// Hull vs hull overlap; result->normal is the direction to move 'b' to separate it from 'a', by result->depth.
+bool hull_hull_collision(ConvexHull const &a, ConvexHull const &b, CollisionResult *result);
+
+// compound_bbox_contacts for a hull: appends a Contact (tagged with object_id) per capsule touching it.
+uint32_t compound_hull_contacts(CapsuleCollider const *capsules, uint32_t capsule_count, ConvexHull const &hull,
+                                uint32_t object_id, std::vector<Contact> *contacts);
@@ -0,0 +1,123 @@
+#include "GroundGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+GroundGrid::Surface GroundGrid::stand_surface(Scene::Transform const &transform) {
+    // corners of each face (bbox corner order as in GenerateBBox) and its normal:
+    static uint32_t const top[4] = {5, 1, 2, 6}, bot[4] = {4, 0, 3, 7}, back[4] = {5, 1, 0, 4};
+    static uint32_t const front[4] = {6, 2, 3, 7}, left[4] = {5, 6, 7, 4}, right[4] = {1, 2, 3, 0};
+    uint32_t const *face;
+    glm::vec3 n;
+    if (transform.top_stand)        { face = top;   n = transform.top_n; }
+    else if (transform.bot_stand)   { face = bot;   n = transform.bot_n; }
+    else if (transform.back_stand)  { face = back;  n = transform.back_n; }
+    else if (transform.front_stand) { face = front; n = transform.front_n; }
+    else if (transform.left_stand)  { face = left;  n = transform.left_n; }
+    else if (transform.right_stand) { face = right; n = transform.right_n; }
+    else throw std::runtime_error(transform.name + " does not have a standable surface\n");
+
+    Surface surface;
+    surface.min = surface.max = glm::vec2(transform.bbox[face[0]]);
+    for (uint32_t i = 1; i < 4; i++) {
+        surface.min = glm::min(surface.min, glm::vec2(transform.bbox[face[i]]));
+        surface.max = glm::max(surface.max, glm::vec2(transform.bbox[face[i]]));
+    }
+    surface.normal = glm::normalize(n);
+    surface.offset = glm::dot(surface.normal, transform.bbox[face[0]]);
+    return surface;
+}
+
+void GroundGrid::reset(AABB const &area, float cell_size) {
+    entries.clear();
+    free_entries.clear();
+    cells.clear();
+
+    glm::vec2 extent = glm::max(glm::vec2(area.max - area.min), glm::vec2(0.f));
+    // keep the grid a sensible size even for a huge (or bogus) area:
+    cell_size = std::max({cell_size, extent.x / 256.f, extent.y / 256.f, 1e-3f});
+    origin = glm::vec2(area.min);
+    inv_cell_size = 1.f / cell_size;
+    size = glm::uvec2(std::max(1u, uint32_t(std::ceil(extent.x * inv_cell_size))),
+                      std::max(1u, uint32_t(std::ceil(extent.y * inv_cell_size))));
+    cells.resize(size.x * size.y);
+}
+
+glm::uvec2 GroundGrid::cell_of(glm::vec2 p) const {
+    glm::vec2 c = glm::floor((p - origin) * inv_cell_size);
+    c = glm::clamp(c, glm::vec2(0.f), glm::vec2(size) - 1.f);
+    return glm::uvec2(c);
+}
+
+void GroundGrid::link(int32_t id) {
+    Entry &entry = entries[id];
+    entry.cell_min = cell_of(entry.surface.min);
+    entry.cell_max = cell_of(entry.surface.max);
+    for (uint32_t y = entry.cell_min.y; y <= entry.cell_max.y; y++) {
+        for (uint32_t x = entry.cell_min.x; x <= entry.cell_max.x; x++) {
+            cells[y * size.x + x].emplace_back(id);
+        }
+    }
+}
+
+void GroundGrid::unlink(int32_t id) {
+    Entry const &entry = entries[id];
+    for (uint32_t y = entry.cell_min.y; y <= entry.cell_max.y; y++) {
+        for (uint32_t x = entry.cell_min.x; x <= entry.cell_max.x; x++) {
+            auto &cell = cells[y * size.x + x];
+            cell.erase(std::find(cell.begin(), cell.end(), id));
+        }
+    }
+}
+
+int32_t GroundGrid::insert(Surface const &surface) {
+    int32_t id;
+    if (free_entries.empty()) {
+        id = int32_t(entries.size());
+        entries.emplace_back();
+    } else {
+        id = free_entries.back();
+        free_entries.pop_back();
+    }
+    entries[id].surface = surface;
+    entries[id].live = true;
+    link(id);
+    return id;
+}
+
+void GroundGrid::move(int32_t id, Surface const &surface) {
+    Entry &entry = entries[id];
+    entry.surface = surface;
+    // most moves stay within the same cells:
+    if (cell_of(surface.min) == entry.cell_min && cell_of(surface.max) == entry.cell_max) return;
+    unlink(id);
+    link(id);
+}
+
+void GroundGrid::remove(int32_t id) {
+    unlink(id);
+    entries[id].live = false;
+    free_entries.emplace_back(id);
+}
+
+bool GroundGrid::nearest_height(glm::vec3 p, uint32_t partitions, float *height, float *dist) const {
+    if (cells.empty()) return false;
+    glm::uvec2 cell = cell_of(glm::vec2(p));
+    bool found = false;
+    for (int32_t id : cells[cell.y * size.x + cell.x]) {
+        Surface const &s = entries[id].surface;
+        if (!(partitions & (1u << s.partition))) continue;
+        if (p.x < s.min.x || p.x > s.max.x || p.y < s.min.y || p.y > s.max.y) continue;
+        if (std::abs(s.normal.z) < 1e-3f) continue; // edge-on, no height to speak of
+
+        float z = (s.offset - s.normal.x * p.x - s.normal.y * p.y) / s.normal.z;
+        if (z < -0.0001f) continue; // below the floor
+        if (std::abs(p.z - z) < *dist) {
+            *dist = std::abs(p.z - z);
+            *height = z;
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Standable surfaces binned into a uniform x/y grid, for "what is under this point" queries (the blob shadow).
+//
+// Each surface is the bbox face GenerateBBox marked standable (Scene::Transform::*_stand), stored once as its
+// x/y extent and plane, so a lookup is one cell fetch plus a plane evaluation per surface in that cell.
+// Surfaces are kept up to date by ObjectStore::insert/refit/remove, so only objects that move cost anything.
+
+#include "Scene.hpp"
+#include "AABBTree.hpp"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct GroundGrid {
+    struct Surface {
+        glm::vec2 min = glm::vec2(0.f), max = glm::vec2(0.f); // x/y extent of the face
+        glm::vec3 normal = glm::vec3(0.f, 0.f, 1.f);          // unit, dot(normal, p) == offset on the face
+        float offset = 0.f;
+        uint32_t partition = 0;                                // queries can skip partitions, see nearest_height
+    };
+    // the standable face of a transform's bbox (throws if none of the *_stand flags is set)
+    static Surface stand_surface(Scene::Transform const &transform);
+
+    // clears the grid and covers 'area' (x/y only) with cells about 'cell_size' wide; surfaces outside the
+    // area still work, they just share the border cells
+    void reset(AABB const &area, float cell_size);
+
+    // returns an id that stays valid until 'remove'
+    int32_t insert(Surface const &surface);
+    void move(int32_t id, Surface const &surface);
+    void remove(int32_t id);
+
+    // Of the surfaces above or below p's x/y (and not under the floor) with their partition's bit set in
+    // 'partitions', the one whose height there is closest to p.z, if closer than *dist; on success sets
+    // *height and *dist (= |p.z - height|).
+    bool nearest_height(glm::vec3 p, uint32_t partitions, float *height, float *dist) const;
+
+    //-- internals ---
+    struct Entry {
+        Surface surface;
+        glm::uvec2 cell_min = glm::uvec2(0), cell_max = glm::uvec2(0); // inclusive cell range it is listed in
+        bool live = false;
+    };
+    std::vector<Entry> entries;
+    std::vector<int32_t> free_entries;
+    std::vector<std::vector<int32_t>> cells; // entry ids, row-major (x fastest)
+    glm::vec2 origin = glm::vec2(0.f);
+    float inv_cell_size = 1.f;
+    glm::uvec2 size = glm::uvec2(0);
+
+    glm::uvec2 cell_of(glm::vec2 p) const;
+    void link(int32_t id);
+    void unlink(int32_t id);
+};
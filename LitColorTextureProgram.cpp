@@ -43,11 +43,28 @@ Load< LitColorTextureProgram > lit_color_texture_program(LoadTagEarly, []() -> L
 	return ret;
 });
 
-LitColorTextureProgram::LitColorTextureProgram() {
+Scene::Drawable::Pipeline lit_color_texture_morph_program_pipeline;
+
+Load< LitColorTextureProgram > lit_color_texture_morph_program(LoadTagEarly, []() -> LitColorTextureProgram const * {
+	LitColorTextureProgram *ret = new LitColorTextureProgram(true);
+
+	//same as above, sharing the white texture:
+	lit_color_texture_morph_program_pipeline = lit_color_texture_program_pipeline;
+	lit_color_texture_morph_program_pipeline.program = ret->program;
+
+	lit_color_texture_morph_program_pipeline.OBJECT_TO_CLIP_mat4 = ret->OBJECT_TO_CLIP_mat4;
+	lit_color_texture_morph_program_pipeline.OBJECT_TO_LIGHT_mat4x3 = ret->OBJECT_TO_LIGHT_mat4x3;
+	lit_color_texture_morph_program_pipeline.NORMAL_TO_LIGHT_mat3 = ret->NORMAL_TO_LIGHT_mat3;
+
+	return ret;
+});
+
+LitColorTextureProgram::LitColorTextureProgram(bool morph) {
 	//Compile vertex and fragment shaders using the convenient 'gl_compile_program' helper function:
 	program = gl_compile_program(
 		//vertex shader:
-		"#version 330\n"
+		std::string("#version 330\n")
+		+ (morph ? "#define MORPH\n" : "") +
 		"uniform mat4 OBJECT_TO_CLIP;\n"
 		"uniform mat4x3 OBJECT_TO_LIGHT;\n"
 		"uniform mat3 NORMAL_TO_LIGHT;\n"
@@ -55,14 +72,26 @@ LitColorTextureProgram::LitColorTextureProgram() {
 		"in vec3 Normal;\n"
 		"in vec4 Color;\n"
 		"in vec2 TexCoord;\n"
+		"#ifdef MORPH\n"
+		"uniform float MORPH_WEIGHT;\n"
+		"in vec4 Position1;\n"
+		"in vec3 Normal1;\n"
+		"#endif\n"
 		"out vec3 position;\n"
 		"out vec3 normal;\n"
 		"out vec4 color;\n"
 		"out vec2 texCoord;\n"
 		"void main() {\n"
-		"	gl_Position = OBJECT_TO_CLIP * Position;\n"
-		"	position = OBJECT_TO_LIGHT * Position;\n"
-		"	normal = NORMAL_TO_LIGHT * Normal;\n"
+		"#ifdef MORPH\n"
+		"	vec4 p = mix(Position, Position1, MORPH_WEIGHT);\n"
+		"	vec3 n = mix(Normal, Normal1, MORPH_WEIGHT);\n"
+		"#else\n"
+		"	vec4 p = Position;\n"
+		"	vec3 n = Normal;\n"
+		"#endif\n"
+		"	gl_Position = OBJECT_TO_CLIP * p;\n"
+		"	position = OBJECT_TO_LIGHT * p;\n"
+		"	normal = NORMAL_TO_LIGHT * n;\n"
 		"	color = Color;\n"
 		"	texCoord = TexCoord;\n"
 		"}\n"
@@ -114,11 +143,14 @@ LitColorTextureProgram::LitColorTextureProgram() {
 	Normal_vec3 = glGetAttribLocation(program, "Normal");
 	Color_vec4 = glGetAttribLocation(program, "Color");
 	TexCoord_vec2 = glGetAttribLocation(program, "TexCoord");
+	Position1_vec4 = glGetAttribLocation(program, "Position1");
+	Normal1_vec3 = glGetAttribLocation(program, "Normal1");
 
 	//look up the locations of uniforms:
 	OBJECT_TO_CLIP_mat4 = glGetUniformLocation(program, "OBJECT_TO_CLIP");
 	OBJECT_TO_LIGHT_mat4x3 = glGetUniformLocation(program, "OBJECT_TO_LIGHT");
 	NORMAL_TO_LIGHT_mat3 = glGetUniformLocation(program, "NORMAL_TO_LIGHT");
+	MORPH_WEIGHT_float = glGetUniformLocation(program, "MORPH_WEIGHT");
 
 	LIGHT_TYPE_int = glGetUniformLocation(program, "LIGHT_TYPE");
 	LIGHT_LOCATION_vec3 = glGetUniformLocation(program, "LIGHT_LOCATION");
@@ -5,8 +5,9 @@
 #include "Scene.hpp"
 
 //Shader program that draws transformed, lit, textured vertices tinted with vertex colors:
+// (the 'morph' variant blends each vertex toward a second keyframe's, see MeshBuffer::make_vao_for_program)
 struct LitColorTextureProgram {
-	LitColorTextureProgram();
+	LitColorTextureProgram(bool morph = false);
 	~LitColorTextureProgram();
 
 	GLuint program = 0;
@@ -16,11 +17,14 @@ struct LitColorTextureProgram {
 	GLuint Normal_vec3 = -1U;
 	GLuint Color_vec4 = -1U;
 	GLuint TexCoord_vec2 = -1U;
+	GLuint Position1_vec4 = -1U; //morph variant: the second keyframe's position and normal
+	GLuint Normal1_vec3 = -1U;
 
 	//Uniform (per-invocation variable) locations:
 	GLuint OBJECT_TO_CLIP_mat4 = -1U;
 	GLuint OBJECT_TO_LIGHT_mat4x3 = -1U;
 	GLuint NORMAL_TO_LIGHT_mat3 = -1U;
+	GLuint MORPH_WEIGHT_float = -1U; //morph variant: 0 draws Position/Normal, 1 draws Position1/Normal1
 
 	//lighting:
 	GLuint LIGHT_TYPE_int = -1U;
@@ -38,3 +42,7 @@ extern Load< LitColorTextureProgram > lit_color_texture_program;
 //For convenient scene-graph setup, copy this object:
 // NOTE: by default, has texture bound to 1-pixel white texture -- so it's okay to use with vertex-color-only meshes.
 extern Scene::Drawable::Pipeline lit_color_texture_program_pipeline;
+
+//The same for the morph variant (MORPH_WEIGHT is up to each drawable's set_uniforms):
+extern Load< LitColorTextureProgram > lit_color_texture_morph_program;
+extern Scene::Drawable::Pipeline lit_color_texture_morph_program_pipeline;
@@ -11,9 +11,7 @@
 #include <set>
 #include <cstddef>
 
-MeshBuffer::MeshBuffer(std::string const &pnct_name, std::string const &bb_name) {
-	glGenBuffers(1, &buffer);
-
+MeshBuffer::MeshBuffer(std::string const &pnct_name, std::string const &bb_name, bool upload_now) {
 	std::ifstream pnct_file(pnct_name, std::ios::binary);
 
 	GLuint total = 0;
@@ -27,17 +25,24 @@ MeshBuffer::MeshBuffer(std::string const &pnct_name, std::string const &bb_name)
 	static_assert(sizeof(Vertex) == 3*4+3*4+4*1+2*4, "Vertex is packed.");
 	std::vector< Vertex > vertex_data;
 
-	//read + upload vertex_data chunk:
+	//read vertex_data chunk (uploaded by upload()):
 	if (pnct_name.size() >= 5 && pnct_name.substr(pnct_name.size()-5) == ".pnct") {
 		read_chunk(pnct_file, "pnct", &vertex_data);
 
-		//upload vertex_data:
-		glBindBuffer(GL_ARRAY_BUFFER, buffer);
-		glBufferData(GL_ARRAY_BUFFER, vertex_data.size() * sizeof(Vertex), vertex_data.data(), GL_STATIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		char const *bytes = reinterpret_cast< char const * >(vertex_data.data());
+		pending_vertices.assign(bytes, bytes + vertex_data.size() * sizeof(Vertex));
 
 		total = GLuint(vertex_data.size()); //store total for later checks on index
 
+		positions.reserve(vertex_data.size());
+		colors.reserve(vertex_data.size());
+		tex_coords.reserve(vertex_data.size());
+		for (auto const &v : vertex_data) {
+			positions.emplace_back(v.Position);
+			colors.emplace_back(v.Color);
+			tex_coords.emplace_back(v.TexCoord);
+		}
+
 		//store attrib locations:
 		Position = Attrib(3, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, Position));
 		Normal = Attrib(3, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, Normal));
@@ -133,6 +138,22 @@ MeshBuffer::MeshBuffer(std::string const &pnct_name, std::string const &bb_name)
 	}
 	std::cout << std::endl;
 	*/
+
+	if (upload_now) upload();
+}
+
+MeshBuffer::~MeshBuffer() {
+	if (buffer != 0) glDeleteBuffers(1, &buffer);
+}
+
+void MeshBuffer::upload() {
+	if (buffer == 0) glGenBuffers(1, &buffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, pending_vertices.size(), pending_vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	pending_vertices = std::vector< char >();
 }
 
 const Mesh &MeshBuffer::lookup(std::string const &name) const {
@@ -151,7 +172,20 @@ const BoundBox &MeshBuffer::lookup_bound_box(std::string const &name) const {
 	return f->second;
 }
 
+bool MeshBuffer::same_surface(GLuint first, GLuint first1, GLuint count) const {
+	GLuint total = GLuint(colors.size());
+	if (!(first <= total && count <= total - first && first1 <= total && count <= total - first1)) return false;
+	for (GLuint i = 0; i < count; ++i) {
+		if (colors[first + i] != colors[first1 + i] || tex_coords[first + i] != tex_coords[first1 + i]) return false;
+	}
+	return true;
+}
+
 GLuint MeshBuffer::make_vao_for_program(GLuint program) const {
+	return make_vao_for_program(program, 0, 0);
+}
+
+GLuint MeshBuffer::make_vao_for_program(GLuint program, GLuint first, GLuint first1) const {
 	//create a new vertex array object:
 	GLuint vao = 0;
 	glGenVertexArrays(1, &vao);
@@ -160,18 +194,21 @@ GLuint MeshBuffer::make_vao_for_program(GLuint program) const {
 	//Try to bind all attributes in this buffer:
 	std::set< GLuint > bound;
 	glBindBuffer(GL_ARRAY_BUFFER, buffer);
-	auto bind_attribute = [&](char const *name, MeshBuffer::Attrib const &attrib) {
+	auto bind_attribute = [&](char const *name, MeshBuffer::Attrib const &attrib, GLuint from) {
 		if (attrib.size == 0) return; //don't bind empty attribs
 		GLint location = glGetAttribLocation(program, name);
 		if (location == -1) return; //can't bind missing attribs
-		glVertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, attrib.stride, (GLbyte *)0 + attrib.offset);
+		GLsizei offset = attrib.offset + GLsizei(from) * attrib.stride;
+		glVertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, attrib.stride, (GLbyte *)0 + offset);
 		glEnableVertexAttribArray(location);
 		bound.insert(location);
 	};
-	bind_attribute("Position", Position);
-	bind_attribute("Normal", Normal);
-	bind_attribute("Color", Color);
-	bind_attribute("TexCoord", TexCoord);
+	bind_attribute("Position", Position, first);
+	bind_attribute("Normal", Normal, first);
+	bind_attribute("Color", Color, first);
+	bind_attribute("TexCoord", TexCoord, first);
+	bind_attribute("Position1", Position, first1);
+	bind_attribute("Normal1", Normal, first1);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
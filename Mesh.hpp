@@ -14,6 +14,7 @@
 #include <map>
 #include <limits>
 #include <string>
+#include <vector>
 
 
 struct Mesh {
@@ -43,7 +44,15 @@ struct BoundBox {
 struct MeshBuffer {
 	//construct from a file:
 	// note: will throw if file fails to read.
-	MeshBuffer(std::string const &pnct_name, std::string const &bb_name);
+	// with upload_now = false nothing touches OpenGL (so it may run on another thread) until upload() is called.
+	MeshBuffer(std::string const &pnct_name, std::string const &bb_name, bool upload_now = true);
+	~MeshBuffer();
+	MeshBuffer(MeshBuffer const &) = delete;
+	MeshBuffer &operator=(MeshBuffer const &) = delete;
+
+	//create 'buffer' from the vertex data read by the constructor (frees the read copy):
+	// note: call from the thread with the OpenGL context.
+	void upload();
 
 	//look up a particular mesh by name:
 	// note: will throw if mesh not found.
@@ -55,12 +64,27 @@ struct MeshBuffer {
 	//build a vertex array object that links this vbo to attributes to a program:
 	// note: will throw if program defines attributes not contained in this buffer
 	GLuint make_vao_for_program(GLuint program) const;
+	//...or one whose vertex 0 is vertex 'first' of this buffer (draw from start = 0), also linking
+	// vertices from 'first1' on to the 'Position1' and 'Normal1' attributes a morph program blends toward:
+	GLuint make_vao_for_program(GLuint program, GLuint first, GLuint first1) const;
 
 	//This is the OpenGL vertex buffer object containing the mesh data:
 	GLuint buffer = 0;
 
+	//CPU-side copy of every vertex position (indexed like the buffer), for building collision meshes:
+	std::vector< glm::vec3 > positions;
+	//...and of the attributes a pose doesn't change, for checking that morph frames share a base mesh:
+	std::vector< glm::u8vec4 > colors;
+	std::vector< glm::vec2 > tex_coords;
+
+	//do the 'count' vertices from 'first' and from 'first1' have the same colors and texture coordinates?
+	bool same_surface(GLuint first, GLuint first1, GLuint count) const;
+
 	//-- internals ---
 
+	//vertex data read but not yet uploaded (see upload()):
+	std::vector< char > pending_vertices;
+
 	//used by the lookup() function:
 	std::map< std::string, Mesh > meshes;
 
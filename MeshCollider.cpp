@@ -0,0 +1,174 @@
+#include "MeshCollider.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    struct BuildTriangle {
+        glm::vec3 p[3];
+        glm::vec3 centroid;
+    };
+}
+
+// Builds the subtree over tris[begin, end) and returns its node index. Splits at the median centroid
+// along the longest axis, with the left side a multiple of TriangleBatch::Width so leaves come out full.
+static uint32_t build_node(MeshCollider *collider, std::vector<BuildTriangle> &tris, uint32_t begin, uint32_t end) {
+    uint32_t node = uint32_t(collider->nodes.size());
+    collider->nodes.emplace_back();
+
+    AABB box, centroids;
+    for (uint32_t i = begin; i < end; i++) {
+        box = box.merged(AABB::from_points(tris[i].p, 3));
+        centroids = centroids.merged(AABB(tris[i].centroid, tris[i].centroid));
+    }
+    collider->nodes[node].box = box;
+
+    uint32_t count = end - begin;
+    if (count <= TriangleBatch::Width) {
+        collider->batches.emplace_back();
+        TriangleBatch &batch = collider->batches.back();
+        for (uint32_t i = begin; i < end; i++) {
+            batch.push(tris[i].p[0], tris[i].p[1], tris[i].p[2]);
+        }
+        collider->nodes[node].leaf = true;
+        collider->nodes[node].index = uint32_t(collider->batches.size()) - 1;
+        return node;
+    }
+
+    glm::vec3 extent = centroids.max - centroids.min;
+    uint32_t axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    uint32_t leaves = (count + TriangleBatch::Width - 1) / TriangleBatch::Width;
+    uint32_t mid = begin + (leaves + 1) / 2 * TriangleBatch::Width;
+    std::nth_element(tris.begin() + begin, tris.begin() + mid, tris.begin() + end,
+        [axis](BuildTriangle const &a, BuildTriangle const &b) { return a.centroid[axis] < b.centroid[axis]; });
+
+    build_node(collider, tris, begin, mid);
+    uint32_t right = build_node(collider, tris, mid, end);
+    collider->nodes[node].index = right;
+    return node;
+}
+
+void MeshCollider::build(glm::vec3 const *positions, uint32_t count, glm::mat4x3 const &to_world) {
+    nodes.clear();
+    batches.clear();
+
+    std::vector<BuildTriangle> tris;
+    tris.reserve(count / 3);
+    for (uint32_t i = 0; i + 2 < count; i += 3) {
+        BuildTriangle tri;
+        for (uint32_t k = 0; k < 3; k++) {
+            tri.p[k] = to_world * glm::vec4(positions[i + k], 1.0f);
+        }
+        glm::vec3 n = glm::cross(tri.p[1] - tri.p[0], tri.p[2] - tri.p[0]);
+        if (!(glm::dot(n, n) > 1e-12f)) continue; // no normal to push along
+        tri.centroid = (tri.p[0] + tri.p[1] + tri.p[2]) / 3.0f;
+        tris.emplace_back(tri);
+    }
+    triangle_count = uint32_t(tris.size());
+    if (tris.empty()) return;
+
+    uint32_t leaves = (triangle_count + TriangleBatch::Width - 1) / TriangleBatch::Width;
+    nodes.reserve(2 * leaves - 1);
+    batches.reserve(leaves);
+    build_node(this, tris, 0, triangle_count);
+}
+
+bool MeshCollider::capsule_collision(glm::vec3 tip, glm::vec3 base, float radius, CollisionResult *result,
+                                     CollisionDebug *debug) const {
+    if (nodes.empty()) return false;
+    AABB box = AABB::around_segment(tip, base, radius);
+
+    bool hit = false;
+    // median splits keep the depth ~log2(leaves):
+    uint32_t stack[64];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        uint32_t index = stack[--top];
+        Node const &node = nodes[index];
+        if (!node.box.overlaps(box)) continue;
+        if (!node.leaf) {
+            assert(top + 2 <= 64);
+            stack[top++] = node.index;
+            stack[top++] = index + 1;
+            continue;
+        }
+
+        CollisionResult candidate;
+        CollisionDebug candidate_debug;
+        uint32_t lane;
+        if (!capsule_triangle_batch_collision(tip, base, radius, &batches[node.index], 1, &candidate, &lane,
+                                              debug ? &candidate_debug : nullptr)) continue;
+        if (!hit || candidate.depth > result->depth) {
+            hit = true;
+            result->point = candidate.point;
+            result->normal = candidate.normal;
+            result->depth = candidate.depth;
+            if (debug) *debug = candidate_debug;
+        }
+    }
+    return hit;
+}
+
+bool MeshCollider::capsule_sweep(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, float *toi,
+                                 CollisionResult *result) const {
+    if (nodes.empty()) return false;
+    AABB start = AABB::around_segment(tip, base, radius);
+    if (!start.merged(AABB(start.min + motion, start.max + motion)).overlaps(bounds())) return false;
+
+    // touching the mesh at t and moving further into it:
+    auto blocked = [&](float t, CollisionResult *r) {
+        return capsule_collision(tip + t * motion, base + t * motion, radius, r) && glm::dot(r->normal, motion) < 0.f;
+    };
+
+    if (blocked(0.f, result)) {
+        *toi = 0.f;
+        return true;
+    }
+
+    float step = std::max(radius, 1e-3f);
+    uint32_t steps = std::max(1u, uint32_t(std::ceil(glm::length(motion) / step)));
+    float clear = 0.f;
+    for (uint32_t k = 1; k <= steps; k++) {
+        float t = float(k) / float(steps);
+        CollisionResult r;
+        if (!blocked(t, &r)) {
+            clear = t;
+            continue;
+        }
+        *result = r;
+        float hit = t;
+        for (uint32_t iter = 0; iter < 10; iter++) {
+            float mid = 0.5f * (clear + hit);
+            if (blocked(mid, &r)) {
+                hit = mid;
+                *result = r;
+            } else {
+                clear = mid;
+            }
+        }
+        *toi = clear;
+        return true;
+    }
+    return false;
+}
+
+uint32_t compound_mesh_contacts(CapsuleCollider const *capsules, uint32_t capsule_count, MeshCollider const &mesh,
+                                uint32_t object_id, std::vector<Contact> *contacts, CollisionDebug *debug) {
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < capsule_count; i++) {
+        Contact contact;
+        CapsuleCollider const &capsule = capsules[i];
+        if (!mesh.capsule_collision(capsule.tip, capsule.base, capsule.radius, &contact.result, debug)) continue;
+        contact.result.object_id = object_id;
+        contact.capsule = i;
+        contact.up = is_almost_up_vec(contact.result.normal);
+        contacts->emplace_back(contact);
+        hits++;
+    }
+    return hits;
+}
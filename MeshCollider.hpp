@@ -0,0 +1,45 @@
+#pragma once
+
+// Triangle-mesh collider, for objects whose eight-corner bbox is a poor fit (thin mats, stairs, ...).
+//
+// The mesh's triangles are baked into world space once and packed four to a TriangleBatch at the
+// leaves of a static BVH, so a capsule query only runs the batch kernel on the few leaves near it.
+
+#include "AABBTree.hpp"
+#include "Collision.hpp"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct MeshCollider {
+    // 'positions' is a GL_TRIANGLES vertex range (e.g. MeshBuffer::positions from Mesh::start, Mesh::count)
+    // and 'to_world' places it in the world; degenerate triangles are dropped. Rebuild if the object moves.
+    void build(glm::vec3 const *positions, uint32_t count, glm::mat4x3 const &to_world);
+
+    // deepest contact between the capsule and the mesh (triangles are two-sided, normal points toward the capsule):
+    bool capsule_collision(glm::vec3 tip, glm::vec3 base, float radius, CollisionResult *result,
+                           CollisionDebug *debug = nullptr) const;
+
+    // capsule_obb_sweep for meshes: the first fraction of 'motion' at which the capsule starts pushing into
+    // the mesh. Samples the motion at most a radius apart (so it can't step over a triangle) and bisects the
+    // first step that hits; *toi is the last clear fraction found.
+    bool capsule_sweep(glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, float *toi,
+                       CollisionResult *result) const;
+
+    AABB bounds() const { return nodes.empty() ? AABB() : nodes[0].box; }
+    uint32_t triangle_count = 0;
+
+    //-- internals ---
+    struct Node {
+        AABB box;
+        uint32_t index = 0; // inner node: right child (the left child is the next node); leaf: batch
+        bool leaf = false;
+    };
+    std::vector<Node> nodes; // depth-first, nodes[0] is the root
+    std::vector<TriangleBatch> batches;
+};
+
+// compound_bbox_contacts for a mesh: appends a Contact (tagged with object_id) per capsule touching it.
+uint32_t compound_mesh_contacts(CapsuleCollider const *capsules, uint32_t capsule_count, MeshCollider const &mesh,
+                                uint32_t object_id, std::vector<Contact> *contacts, CollisionDebug *debug = nullptr);
@@ -0,0 +1,73 @@
+#include "ObjectStore.hpp"
+
+uint32_t ObjectStore::create(RoomObject const &obj) {
+    uint32_t h = uint32_t(size());
+    obb.emplace_back(make_oriented_box(obj.transform->bbox));
+    bounds.emplace_back();
+    type.emplace_back(uint8_t(obj.collision_type));
+    flags.emplace_back(obj.flags);
+    category.emplace_back(obj.category);
+    partition.emplace_back(0);
+    mesh.emplace_back();
+    hull.emplace_back();
+    tree.emplace_back(nullptr);
+    proxy.emplace_back(-1);
+    ground.emplace_back(nullptr);
+    surface.emplace_back(-1);
+    transform.emplace_back(obj.transform);
+    object.emplace_back(nullptr);
+    return h;
+}
+
+AABB ObjectStore::world_box(uint32_t h) const {
+    AABB box = AABB::from_points(transform[h]->bbox, 8);
+    if (mesh[h]) box = box.merged(mesh[h]->bounds());
+    if (hull[h]) box = box.merged(hull[h]->bounds);
+    return box;
+}
+
+GroundGrid::Surface ObjectStore::stand_surface(uint32_t h) const {
+    GroundGrid::Surface s = GroundGrid::stand_surface(*transform[h]);
+    s.partition = partition[h];
+    return s;
+}
+
+void ObjectStore::insert(uint32_t h, AABBTree *tree_, GroundGrid *ground_) {
+    obb[h] = make_oriented_box(transform[h]->bbox);
+    bounds[h] = world_box(h);
+    tree[h] = tree_;
+    proxy[h] = tree_->insert(bounds[h], h);
+    ground[h] = ground_;
+    surface[h] = ground_->insert(stand_surface(h));
+}
+
+void ObjectStore::remove(uint32_t h) {
+    if (!tree[h]) return;
+    tree[h]->remove(proxy[h]);
+    tree[h] = nullptr;
+    proxy[h] = -1;
+    ground[h]->remove(surface[h]);
+    ground[h] = nullptr;
+    surface[h] = -1;
+}
+
+void ObjectStore::refit(uint32_t h) {
+    obb[h] = make_oriented_box(transform[h]->bbox);
+    bounds[h] = world_box(h);
+    if (tree[h]) tree[h]->move(proxy[h], bounds[h]);
+    if (ground[h]) ground[h]->move(surface[h], stand_surface(h));
+}
+
+bool ObjectStore::capsule_collision(uint32_t h, glm::vec3 tip, glm::vec3 base, float radius,
+                                    CollisionResult *result) const {
+    if (mesh[h]) return mesh[h]->capsule_collision(tip, base, radius, result);
+    if (hull[h]) return capsule_hull_collision(tip, base, radius, *hull[h], result);
+    return capsule_bbox_collision(tip, base, radius, obb[h], result);
+}
+
+bool ObjectStore::capsule_sweep(uint32_t h, glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion,
+                                float *toi, CollisionResult *result) const {
+    if (mesh[h]) return mesh[h]->capsule_sweep(tip, base, radius, motion, toi, result);
+    if (hull[h]) return capsule_hull_sweep(tip, base, radius, motion, *hull[h], toi, result);
+    return capsule_obb_sweep(tip, base, radius, motion, obb[h], toi, result);
+}
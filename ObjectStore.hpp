@@ -0,0 +1,68 @@
+#pragma once
+
+// Collision-side state of every RoomObject, kept in parallel arrays indexed by a handle (RoomObject::id).
+//
+// The broadphase tree stores handles, and the narrowphase only needs the hot arrays below (boxes, colliders,
+// type, flags, room), so queries walk a few contiguous arrays instead of whole RoomObjects. Handles never
+// move: inserting into or erasing from PlayMode::world_objects only has to refresh the 'object' side table.
+// Everything else about an object (names, reaction drawables, sounds, its body) stays on RoomObject.
+
+#include "RoomObject.hpp"
+#include "AABBTree.hpp"
+#include "Collision.hpp"
+#include "MeshCollider.hpp"
+#include "ConvexHull.hpp"
+#include "GroundGrid.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ObjectStore {
+    static constexpr uint32_t NoObject = -1U; // what queries return when they hit nothing
+
+    // new handle for 'obj' (copies its transform, collision type, flags and category); not in the tree until 'insert'
+    uint32_t create(RoomObject const &obj);
+    size_t size() const { return obb.size(); }
+
+    // ----- hot: read by every query -----
+    std::vector< OrientedBox > obb;      // bbox as an oriented box, rebuilt on insert/refit
+    std::vector< AABB > bounds;          // world box (bbox merged with mesh/hull) the tree holds
+    std::vector< uint8_t > type;         // CollisionType
+    std::vector< uint32_t > flags;       // RoomObject::Flags
+    std::vector< uint32_t > category;    // RoomObject::Category
+    std::vector< uint8_t > partition;    // room it lives in (PlayMode::RoomType); set before 'insert'
+    // the object's own triangles, for objects the bbox fits badly, and convex hull of its vertices, for static
+    // furniture the bbox over-covers (see PlayMode::build_colliders); both baked in world space
+    std::vector< std::shared_ptr< MeshCollider const > > mesh;
+    std::vector< std::shared_ptr< ConvexHull const > > hull;
+
+    // ----- registration -----
+    std::vector< AABBTree * > tree;      // the tree the object is in, nullptr while out of play
+    std::vector< int32_t > proxy;
+    std::vector< GroundGrid * > ground;  // and the grid holding its standable surface
+    std::vector< int32_t > surface;
+
+    // ----- cold side tables -----
+    std::vector< Scene::Transform * > transform;
+    // the RoomObject in PlayMode::world_objects, nullptr while the cat holds it (see PlayMode::relink_world_objects)
+    std::vector< RoomObject * > object;
+
+    bool in_room(uint32_t h) const { return tree[h] != nullptr; }
+    // is it in one of the partitions with a bit set in 'partitions'?
+    bool in_partitions(uint32_t h, uint32_t partitions) const { return partitions & (1u << partition[h]); }
+    // bbox merged with any mesh/hull bounds, from the transform as it is now
+    AABB world_box(uint32_t h) const;
+    // its standable face, tagged with its partition
+    GroundGrid::Surface stand_surface(uint32_t h) const;
+
+    void insert(uint32_t h, AABBTree *tree_, GroundGrid *ground_);
+    void remove(uint32_t h);
+    // call after transform->bbox changes so queries see the new box
+    void refit(uint32_t h);
+
+    // capsule vs the tightest collider the object has: triangles, else hull, else bbox
+    bool capsule_collision(uint32_t h, glm::vec3 tip, glm::vec3 base, float radius, CollisionResult *result) const;
+    bool capsule_sweep(uint32_t h, glm::vec3 tip, glm::vec3 base, float radius, glm::vec3 motion, float *toi,
+                       CollisionResult *result) const;
+};
@@ -11,7 +11,10 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include <random>
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
+#include <memory>
 
 GLuint shadow_meshes_for_blob_shadow_texture_program = 0;
 Load< MeshBuffer > shadow_meshes(LoadTagDefault, []() -> MeshBuffer const * {
@@ -30,23 +33,7 @@ Load< MeshBuffer > cat_meshes(LoadTagDefault, []() -> MeshBuffer const * {
 	return ret;
 });
 
-GLuint living_room_meshes_for_lit_color_texture_program = 0;
-// GLuint living_room_meshes_for_blob_shadow_texture_program = 0;
-Load< MeshBuffer > living_room_meshes(LoadTagDefault, []() -> MeshBuffer const * {
-	MeshBuffer const *ret = new MeshBuffer(data_path("living_room.pnct"), data_path("living_room.boundbox"));
-	living_room_meshes_for_lit_color_texture_program = ret->make_vao_for_program(lit_color_texture_program->program);
-    // living_room_meshes_for_blob_shadow_texture_program = ret->make_vao_for_program(blob_shadow_texture_program->program);
-	return ret;
-});
-
-GLuint kitchen_meshes_for_lit_color_texture_program = 0;
-Load< MeshBuffer > kitchen_meshes(LoadTagDefault, []() -> MeshBuffer const * {
-    printf("Creating Kitchen Meshes\n");
-	MeshBuffer const *ret = new MeshBuffer(data_path("kitchen.pnct"), data_path("kitchen.boundbox"));
-	kitchen_meshes_for_lit_color_texture_program = ret->make_vao_for_program(lit_color_texture_program->program);
-	return ret;
-});
-
+// (the rooms' own meshes and scenes are read when the cat comes near them, see PlayMode::stream_rooms)
 GLuint walls_doors_floors_stairs_meshes_for_lit_color_texture_program = 0;
 Load< MeshBuffer > walls_doors_floors_stairs_meshes(LoadTagDefault, []() -> MeshBuffer const * {
     printf("Creating walls_doors_floors_stairs Meshes\n");
@@ -55,30 +42,6 @@ Load< MeshBuffer > walls_doors_floors_stairs_meshes(LoadTagDefault, []() -> Mesh
 	return ret;
 });
 
-GLuint bedroom_meshes_for_lit_color_texture_program = 0;
-Load< MeshBuffer > bedroom_meshes(LoadTagDefault, []() -> MeshBuffer const * {
-    printf("Creating Bedroom Meshes\n");
-	MeshBuffer const *ret = new MeshBuffer(data_path("bedroom.pnct"), data_path("bedroom.boundbox"));
-	bedroom_meshes_for_lit_color_texture_program = ret->make_vao_for_program(lit_color_texture_program->program);
-	return ret;
-});
-
-GLuint bathroom_meshes_for_lit_color_texture_program = 0;
-Load< MeshBuffer > bathroom_meshes(LoadTagDefault, []() -> MeshBuffer const * {
-    printf("Creating Bathroom Meshes\n");
-	MeshBuffer const *ret = new MeshBuffer(data_path("bathroom.pnct"), data_path("bathroom.boundbox"));
-	bathroom_meshes_for_lit_color_texture_program = ret->make_vao_for_program(lit_color_texture_program->program);
-	return ret;
-});
-
-GLuint office_meshes_for_lit_color_texture_program = 0;
-Load< MeshBuffer > office_meshes(LoadTagDefault, []() -> MeshBuffer const * {
-    printf("Creating Office Meshes\n");
-	MeshBuffer const *ret = new MeshBuffer(data_path("office.pnct"), data_path("office.boundbox"));
-	office_meshes_for_lit_color_texture_program = ret->make_vao_for_program(lit_color_texture_program->program);
-	return ret;
-});
-
 GLuint bounds_meshes_for_lit_color_texture_program = 0;
 Load< MeshBuffer > bounds_meshes(LoadTagDefault, []() -> MeshBuffer const * {
     printf("Creating Bounds Meshes\n");
@@ -95,14 +58,15 @@ float angleBetween(glm::vec3 x, glm::vec3 y) {
 Load< Scene > cat_scene_load(LoadTagDefault, []() -> Scene const * {
 	return new Scene(data_path("cat.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
 		Mesh const &mesh = cat_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
+		Scene::Drawable &drawable = scene.drawables.emplace_back(transform);
 
 		drawable.pipeline = lit_color_texture_program_pipeline;
 		drawable.pipeline.vao = cat_meshes_for_lit_color_texture_program;
 		drawable.pipeline.type = mesh.type;
 		drawable.pipeline.start = mesh.start;
 		drawable.pipeline.count = mesh.count;
+		drawable.min = mesh.min;
+		drawable.max = mesh.max;
 
 	});
 });
@@ -111,116 +75,32 @@ Load< Scene > shadow_scene_load(LoadTagDefault, []() -> Scene const * {
 	return new Scene(data_path("shadow.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
 		Mesh const &mesh = shadow_meshes->lookup(mesh_name);
 
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
+		Scene::Drawable &drawable = scene.drawables.emplace_back(transform);
         
         drawable.pipeline = blob_shadow_texture_program_pipeline;
         drawable.pipeline.vao = shadow_meshes_for_blob_shadow_texture_program;
         drawable.pipeline.type = mesh.type;
 		drawable.pipeline.start = mesh.start;
 		drawable.pipeline.count = mesh.count;
+		drawable.min = mesh.min;
+		drawable.max = mesh.max;
 	});
 });
 
 
-Load< Scene > living_room_scene_load(LoadTagDefault, []() -> Scene const * {
-	return new Scene(data_path("living_room.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
-		Mesh const &mesh = living_room_meshes->lookup(mesh_name);
-
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
-        
-        // if (transform->name == "CatShadow") {
-        //     drawable.pipeline = blob_shadow_texture_program_pipeline;
-        //     drawable.pipeline.vao = living_room_meshes_for_blob_shadow_texture_program;
-        //     drawable.last_pass = true;
-        // }
-        // else {
-        drawable.pipeline = lit_color_texture_program_pipeline;
-        drawable.pipeline.vao = living_room_meshes_for_lit_color_texture_program;
-        // }
-        drawable.pipeline.type = mesh.type;
-		drawable.pipeline.start = mesh.start;
-		drawable.pipeline.count = mesh.count;
-	});
-});
-
-Load< Scene > kitchen_scene_load(LoadTagDefault, []() -> Scene const * {
-	return new Scene(data_path("kitchen.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
-        // printf("Mesh Name: %s\n", mesh_name.c_str());
-		Mesh const &mesh = kitchen_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
-
-		drawable.pipeline = lit_color_texture_program_pipeline;
-		drawable.pipeline.vao = kitchen_meshes_for_lit_color_texture_program;
-		drawable.pipeline.type = mesh.type;
-		drawable.pipeline.start = mesh.start;
-		drawable.pipeline.count = mesh.count;
-
-	});
-});
-
 Load< Scene > walls_doors_floors_stairs_scene_load(LoadTagDefault, []() -> Scene const * {
 	return new Scene(data_path("walls_doors_floors_stairs.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
         // printf("Mesh Name: %s\n", mesh_name.c_str());
 		Mesh const &mesh = walls_doors_floors_stairs_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
+		Scene::Drawable &drawable = scene.drawables.emplace_back(transform);
 
 		drawable.pipeline = lit_color_texture_program_pipeline;
 		drawable.pipeline.vao = walls_doors_floors_stairs_meshes_for_lit_color_texture_program;
 		drawable.pipeline.type = mesh.type;
 		drawable.pipeline.start = mesh.start;
 		drawable.pipeline.count = mesh.count;
-
-	});
-});
-
-Load< Scene > bedroom_scene_load(LoadTagDefault, []() -> Scene const * {
-	return new Scene(data_path("bedroom.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
-        // printf("Mesh Name: %s\n", mesh_name.c_str());
-		Mesh const &mesh = bedroom_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
-
-		drawable.pipeline = lit_color_texture_program_pipeline;
-		drawable.pipeline.vao = bedroom_meshes_for_lit_color_texture_program;
-		drawable.pipeline.type = mesh.type;
-		drawable.pipeline.start = mesh.start;
-		drawable.pipeline.count = mesh.count;
-
-	});
-});
-
-Load< Scene > bathroom_scene_load(LoadTagDefault, []() -> Scene const * {
-	return new Scene(data_path("bathroom.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
-        // printf("Mesh Name: %s\n", mesh_name.c_str());
-		Mesh const &mesh = bathroom_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
-
-		drawable.pipeline = lit_color_texture_program_pipeline;
-		drawable.pipeline.vao = bathroom_meshes_for_lit_color_texture_program;
-		drawable.pipeline.type = mesh.type;
-		drawable.pipeline.start = mesh.start;
-		drawable.pipeline.count = mesh.count;
-
-	});
-});
-
-Load< Scene > office_scene_load(LoadTagDefault, []() -> Scene const * {
-	return new Scene(data_path("office.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
-        // printf("Mesh Name: %s\n", mesh_name.c_str());
-		Mesh const &mesh = office_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
-
-		drawable.pipeline = lit_color_texture_program_pipeline;
-		drawable.pipeline.vao = office_meshes_for_lit_color_texture_program;
-		drawable.pipeline.type = mesh.type;
-		drawable.pipeline.start = mesh.start;
-		drawable.pipeline.count = mesh.count;
+		drawable.min = mesh.min;
+		drawable.max = mesh.max;
 
 	});
 });
@@ -229,14 +109,15 @@ Load< Scene > bounds_scene_load(LoadTagDefault, []() -> Scene const * {
 	return new Scene(data_path("bounds.scene"), [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name){
         // printf("Mesh Name: %s\n", mesh_name.c_str());
 		Mesh const &mesh = bounds_meshes->lookup(mesh_name);
-		scene.drawables.emplace_back(transform);
-		Scene::Drawable &drawable = scene.drawables.back();
+		Scene::Drawable &drawable = scene.drawables.emplace_back(transform);
 
 		drawable.pipeline = lit_color_texture_program_pipeline;
 		drawable.pipeline.vao = bounds_meshes_for_lit_color_texture_program;
 		drawable.pipeline.type = mesh.type;
 		drawable.pipeline.start = mesh.start;
 		drawable.pipeline.count = mesh.count;
+		drawable.min = mesh.min;
+		drawable.max = mesh.max;
 
 	});
 });
@@ -313,117 +194,22 @@ float get_top_height(Scene::Transform *transform) {
     return 0.f;
 }
 
-bool shadow_intersect(Scene::Transform *transform, glm::vec3 cat_pos, glm::vec3 &intersect_pt) {
-    // Raycast down from player position to object top surface bbox planes
-    // Using ray-plane intersection equation from http://15462.courses.cs.cmu.edu/fall2021/lecture/geometricqueries/slide_021
-
-    // Gather true "top" plane normal, offset
-    glm::vec3 N;
-    float offset, x_min, x_max, y_min, y_max;
-    if (transform->top_stand) {
-        x_min = std::min({transform->bbox[5].x, transform->bbox[1].x, transform->bbox[2].x, transform->bbox[6].x});
-        x_max = std::max({transform->bbox[5].x, transform->bbox[1].x, transform->bbox[2].x, transform->bbox[6].x});
-        y_min = std::min({transform->bbox[5].y, transform->bbox[1].y, transform->bbox[2].y, transform->bbox[6].y});
-        y_max = std::max({transform->bbox[5].y, transform->bbox[1].y, transform->bbox[2].y, transform->bbox[6].y});
-
-        N = glm::normalize(transform->top_n);
-        offset = glm::dot(N, transform->bbox[2]);
-    }
-    else if (transform->bot_stand) {
-        x_min = std::min({transform->bbox[4].x, transform->bbox[0].x, transform->bbox[3].x, transform->bbox[7].x});
-        x_max = std::max({transform->bbox[4].x, transform->bbox[0].x, transform->bbox[3].x, transform->bbox[7].x});
-        y_min = std::min({transform->bbox[4].y, transform->bbox[0].y, transform->bbox[3].y, transform->bbox[7].y});
-        y_max = std::max({transform->bbox[4].y, transform->bbox[0].y, transform->bbox[3].y, transform->bbox[7].y});
-        
-        N = transform->bot_n;
-        offset = glm::dot(N, transform->bbox[4]);
-    }
-    else if (transform->back_stand) {
-        x_min = std::min({transform->bbox[5].x, transform->bbox[1].x, transform->bbox[0].x, transform->bbox[4].x});
-        x_max = std::max({transform->bbox[5].x, transform->bbox[1].x, transform->bbox[0].x, transform->bbox[4].x});
-        y_min = std::min({transform->bbox[5].y, transform->bbox[1].y, transform->bbox[0].y, transform->bbox[4].y});
-        y_max = std::max({transform->bbox[5].y, transform->bbox[1].y, transform->bbox[0].y, transform->bbox[4].y});
-
-        N = transform->back_n;
-        offset = glm::dot(N, transform->bbox[1]);
-    }
-    else if (transform->front_stand) {
-        x_min = std::min({transform->bbox[6].x, transform->bbox[2].x, transform->bbox[3].x, transform->bbox[7].x});
-        x_max = std::max({transform->bbox[6].x, transform->bbox[2].x, transform->bbox[3].x, transform->bbox[7].x});
-        y_min = std::min({transform->bbox[6].y, transform->bbox[2].y, transform->bbox[3].y, transform->bbox[7].y});
-        y_max = std::max({transform->bbox[6].y, transform->bbox[2].y, transform->bbox[3].y, transform->bbox[7].y});
-
-        N = transform->front_n;
-        offset = glm::dot(N, transform->bbox[2]);
-    }
-    else if (transform->left_stand) {
-        x_min = std::min({transform->bbox[5].x, transform->bbox[6].x, transform->bbox[7].x, transform->bbox[4].x});
-        x_max = std::max({transform->bbox[5].x, transform->bbox[6].x, transform->bbox[7].x, transform->bbox[4].x});
-        y_min = std::min({transform->bbox[5].y, transform->bbox[6].y, transform->bbox[7].y, transform->bbox[4].y});
-        y_max = std::max({transform->bbox[5].y, transform->bbox[6].y, transform->bbox[7].y, transform->bbox[4].y});
-
-        N = transform->left_n;
-        offset = glm::dot(N, transform->bbox[5]);
-    }
-    else if (transform->right_stand) {
-        x_min = std::min({transform->bbox[1].x, transform->bbox[2].x, transform->bbox[3].x, transform->bbox[0].x});
-        x_max = std::max({transform->bbox[1].x, transform->bbox[2].x, transform->bbox[3].x, transform->bbox[0].x});
-        y_min = std::min({transform->bbox[1].y, transform->bbox[2].y, transform->bbox[3].y, transform->bbox[0].y});
-        y_max = std::max({transform->bbox[1].y, transform->bbox[2].y, transform->bbox[3].y, transform->bbox[0].y});
-
-        N = transform->right_n;
-        offset = glm::dot(N, transform->bbox[1]); 
-    }
-    else throw std::runtime_error(transform->name + " does not have a standable surface\n");
-
-    if ((cat_pos.x < x_min) || (cat_pos.x > x_max) || (cat_pos.y < y_min) || (cat_pos.y > y_max)) return false;
-
-
-    glm::vec3 d = glm::vec3(0, 0, -cat_pos.z);
-
-    // Don't want to project shadows on parallel surfaces
-    if (std::abs(glm::dot(N, d)) < 0.001f) return false;
-
-    float t = (offset - glm::dot(N, cat_pos)) / glm::dot(N, d);
-    // if (t < 0) return false;                                     TODO: Check if it intersects? above? cat position
-
-    glm::vec3 plane_pos = cat_pos + d*t;
-
-    if (plane_pos.z < -0.0001f) return false;      // intersects below floor
-
-    // Save intersection point
-    intersect_pt = plane_pos;
-    // intersect_pt.z += 1.0f;
-    // std::cout << glm::to_string(intersect_pt) << std::endl;
-    return true;
-}
-
+// Height of the standable surface straight above or below the cat that is closest to it (the cat's own
+// height if none), for placing the blob shadow; closest_dist gets the vertical distance to it.
 float PlayMode::get_surface_below_height(float &closest_dist) {
     float height = player.base.z;
     closest_dist = player.base.z + 0.0001f;
 
-    for (auto room_type : current_rooms) {
-        switch_rooms(room_type);
-        for (auto obj : *current_objects) {
-            glm::vec3 intersect_pt;
-            if (shadow_intersect(obj.transform, player.base, intersect_pt)) {
-                float dist;
-                if ((dist = glm::length(intersect_pt - player.base)) < closest_dist) {
-                    closest_dist = dist;
-                    height = intersect_pt.z;
-                }
-            }
-        }
-    }
+    world_ground.nearest_height(player.base, current_rooms, &height, &closest_dist);
 
     return height;
 }
 
 
-void PlayMode::GenerateBBox(Scene &scene, Load<MeshBuffer> &meshes) {
+void PlayMode::GenerateBBox(Scene &scene, MeshBuffer const &meshes) {
 
     for (auto &drawable : scene.drawables) {
-        BoundBox const &bbox = meshes->lookup_bound_box(drawable.transform->name);
+        BoundBox const &bbox = meshes.lookup_bound_box(drawable.transform->name);
 
         drawable.transform->bbox[0] = bbox.P1;
         drawable.transform->bbox[1] = bbox.P2;
@@ -515,58 +301,98 @@ void PlayMode::GenerateBBox(Scene &scene, Load<MeshBuffer> &meshes) {
 }
 
 // animation code
-bool SearchFrameByName(Scene &scene, std::string name) {
-    auto frame_iter = find_if(scene.drawables.begin(), scene.drawables.end(),
-                                [name](const Scene::Drawable & elem) { return elem.transform->name == name; });
-    return frame_iter != scene.drawables.end();
-}
-
 bool RemoveFrameByName(Scene &scene, std::string name) {
-    auto frame_iter = find_if(scene.drawables.begin(), scene.drawables.end(),
+    auto frame_iter = std::find_if(scene.drawables.begin(), scene.drawables.end(),
                                 [name](const Scene::Drawable & elem) { return elem.transform->name == name; });
     if (frame_iter == scene.drawables.end()) return false;
     scene.drawables.erase(frame_iter);
     return true;
 }
 
-void AddFrame(Scene &scene, Scene::Drawable &drawable) {
-    scene.drawables.push_back(drawable);
-}
-
-void RemoveAllFrames(Scene &scene) {
-    while (scene.drawables.begin() != scene.drawables.end()) {
-        scene.drawables.erase(scene.drawables.begin());
-    }
-}
-
 void GetFrames(Scene &scene, PlayMode::Animation &animation, std::string name) {
     animation.name = name;
     for (uint32_t idx = 0; idx < animation.frame_times.size(); ++idx) {
         std::string frame_name = animation.name + std::to_string(idx);
-        auto frame_iter = find_if(scene.drawables.begin(), scene.drawables.end(),
+        auto frame_iter = std::find_if(scene.drawables.begin(), scene.drawables.end(),
                                 [frame_name](const Scene::Drawable & elem) { return elem.transform->name == frame_name; });
-        animation.frames.push_back(*frame_iter);
-        scene.drawables.erase(frame_iter);
+        animation.frames.push_back(&*frame_iter);
     }
 }
 
-void PlayMode::Animation::animate(Scene &scene, bool enable, float elapsed) {
-    if (!enable) return;
+// Frames exported from one mesh in different poses have matching vertices, so each is drawn blended toward the
+// next by animation.weight (LitColorTextureProgram's morph variant). An animation whose frames aren't all the same
+// base mesh (same vertex count, colors and texture coordinates) is just swapped frame to frame instead.
+void MorphFrames(PlayMode::Animation &animation, MeshBuffer const &meshes) {
+    std::vector<Scene::Drawable> plain;
+    for (auto const *frame : animation.frames) plain.push_back(*frame);
+
+    bool same_mesh = !plain.empty();
+    for (auto const &frame : plain) {
+        Scene::Drawable::Pipeline const &first = plain[0].pipeline;
+        if (frame.pipeline.type != GL_TRIANGLES || frame.pipeline.count != first.count
+            || !meshes.same_surface(first.start, frame.pipeline.start, first.count)) {
+            same_mesh = false;
+            break;
+        }
+    }
+    if (!same_mesh) {
+        std::cerr << "WARNING: frames of cat animation '" << animation.name
+                  << "' aren't poses of one mesh; switching between them without blending." << std::endl;
+        animation.morphs.assign(plain.size(), false);
+        return;
+    }
 
-    timer += elapsed;
-    std::string old_frame_name = name + std::to_string(frame_idx);
-    bool found = SearchFrameByName(scene, old_frame_name);
+    PlayMode::Animation const *weights = &animation;
+    for (uint32_t idx = 0; idx < plain.size(); ++idx) {
+        Scene::Drawable::Pipeline const &from = plain[idx].pipeline;
+        Scene::Drawable::Pipeline const &to = plain[(idx + 1) % plain.size()].pipeline;
+        animation.morphs.push_back(true);
+
+        // a blended frame is somewhere between the two poses, so it is culled by the box around both:
+        Scene::Drawable &frame = *animation.frames[idx];
+        frame.min = glm::min(plain[idx].min, plain[(idx + 1) % plain.size()].min);
+        frame.max = glm::max(plain[idx].max, plain[(idx + 1) % plain.size()].max);
+
+        Scene::Drawable::Pipeline &pipeline = frame.pipeline;
+        pipeline = lit_color_texture_morph_program_pipeline;
+        pipeline.vao = meshes.make_vao_for_program(pipeline.program, from.start, to.start);
+        pipeline.type = from.type;
+        pipeline.start = 0;
+        pipeline.count = from.count;
+        pipeline.set_uniforms = [weights]() {
+            glUniform1f(lit_color_texture_morph_program->MORPH_WEIGHT_float, weights->weight);
+        };
+    }
+}
 
-    if (!found || frame_times[frame_idx] <= timer) {
-        if (RemoveFrameByName(scene, old_frame_name)) { // continuing this animation
-            frame_idx = (frame_idx + 1) % frames.size();
-        } else { // was in the middle of another animation
-            RemoveAllFrames(scene);
-            frame_idx = 0;
-        }
+void PlayMode::Animation::animate(Animation *&playing, float elapsed) {
+    if (playing != this) { // was in the middle of another animation
+        frame_idx = 0;
+        timer = 0.f;
+        weight = 0.f;
+        show(playing);
+        return;
+    }
+
+    timer += elapsed;
+    if (timer >= frame_times[frame_idx]) {
+        frames[frame_idx]->hidden = true;
+        frame_idx = (frame_idx + 1) % frames.size();
+        frames[frame_idx]->hidden = false;
         timer = 0.f;
-        AddFrame(scene, frames[frame_idx]);
     }
+    weight = morphs[frame_idx] ? std::min(timer / frame_times[frame_idx], 1.f) : 0.f;
+}
+
+glm::vec3 PlayMode::Animation::mouth_position() const {
+    glm::vec3 const &next = mouth[(frame_idx + 1) % mouth.size()];
+    return glm::mix(mouth[frame_idx], next, weight);
+}
+
+void PlayMode::Animation::show(Animation *&playing) {
+    if (playing) playing->frames[playing->frame_idx]->hidden = true;
+    playing = this;
+    frames[frame_idx]->hidden = false;
 }
 
 void PlayMode::generate_wdfs_objects(Scene &scene, std::vector<RoomObject> &objects) {
@@ -575,6 +401,8 @@ void PlayMode::generate_wdfs_objects(Scene &scene, std::vector<RoomObject> &obje
             drawable.transform->name.find("Pass") == std::string::npos) {
             CollisionType type = CollisionType::None;
             objects.push_back( RoomObject(drawable.transform, type) );
+        } else {
+            room_graph.add_portal(AABB::from_points(drawable.transform->bbox, 8));
         }
 
         if (drawable.transform->name == "First Floor") {
@@ -637,11 +465,12 @@ void PlayMode::generate_living_room_objects(Scene &scene, std::vector<RoomObject
         if (drawable.transform->name == "Magazine") {
             objects.back().has_sound = true;
             objects.back().samples.push_back(&papers);
+            objects.back().flags |= RoomObject::CameraTransparent; // its knocked-over mesh has a misleading bbox
         }
     }
 
     // ----- Search for FALLING objects to set start/end heights -----
-    auto vase_iter = find_if(objects.begin(), objects.end(),
+    auto vase_iter = std::find_if(objects.begin(), objects.end(),
                             [](const RoomObject &elem) { return elem.transform->name == "Vase"; });
     RoomObject &vase_obj = *(vase_iter);
     vase_obj.start_height = vase_obj.transform->position.z;
@@ -732,7 +561,7 @@ void PlayMode::generate_kitchen_objects(Scene &scene, std::vector<RoomObject> &o
         }
 
         // ----- Search for FALLING objects to set start/end heights -----
-        auto plate1_iter = find_if(objects.begin(), objects.end(),
+        auto plate1_iter = std::find_if(objects.begin(), objects.end(),
                                 [](const RoomObject &elem) { return elem.transform->name == "Plate"; });
         RoomObject &plate1 = *(plate1_iter);
         plate1.start_height = plate1.transform->position.z;
@@ -740,7 +569,7 @@ void PlayMode::generate_kitchen_objects(Scene &scene, std::vector<RoomObject> &o
         plate1.x_min = island_x_min; plate1.x_max = island_x_max;
         plate1.y_min = island_y_min; plate1.y_max = island_y_max;
 
-        auto plate2_iter = find_if(objects.begin(), objects.end(),
+        auto plate2_iter = std::find_if(objects.begin(), objects.end(),
                                 [](const RoomObject &elem) { return elem.transform->name == "Plate.001"; });
         RoomObject &plate2 = *(plate2_iter);
         plate2.start_height = plate2.transform->position.z;
@@ -920,13 +749,19 @@ void PlayMode::generate_room_objects(Scene &scene, std::vector<RoomObject> &obje
 
     // Applies for all rooms
     for (auto &obj: objects) {
+        // landing spots that score for stolen things (before create, which copies the category)
+        if (obj.name == "Cat Bed") obj.category |= RoomObject::ToyBin;
+        if (obj.name == "Toilet.002") obj.category |= RoomObject::Drain;
+        obj.home = uint8_t(room_type);
+        obj.id = store.create(obj);
+
         // Lookup after-collision drawable
         if ((obj.collision_type == CollisionType::PushOff) 
             || (obj.collision_type == CollisionType::KnockOver) 
             || (obj.collision_type == CollisionType::Destroy)) {
             
             auto obj_name = obj.name;
-            auto collided_iter = find_if(scene.drawables.begin(), scene.drawables.end(),
+            auto collided_iter = std::find_if(scene.drawables.begin(), scene.drawables.end(),
                     [obj_name](const Scene::Drawable &elem) { return elem.transform->name == (obj_name + " Collided"); });
             if (collided_iter == scene.drawables.end()) std::cerr << "ERROR: Could not find post-collision resolution mesh associated with " << obj_name << std::endl;
             obj.reaction_drawables.push_back(*collided_iter);
@@ -935,107 +770,213 @@ void PlayMode::generate_room_objects(Scene &scene, std::vector<RoomObject> &obje
     }
 }
 
-void PlayMode::switch_rooms(RoomType room_type) {
-    switch (room_type) {
-        case RoomType::LivingRoom: {
-            current_scene   = &living_room_scene;
-            current_objects = &living_room_objects;
-            break;
-        }
-        case RoomType::Kitchen: {
-            current_scene   = &kitchen_scene;
-            current_objects = &kitchen_objects;
-            break;
-        }
-        case RoomType::WallsDoorsFloorsStairs: {
-            current_scene   = &wdfs_scene;
-            current_objects = &wdfs_objects;
-            break;
-        }
-        case RoomType::Bedroom: {
-            current_scene   = &bedroom_scene;
-            current_objects = &bedroom_objects;
-            break;
-        }
-        case RoomType::Bathroom: {
-            current_scene   = &bathroom_scene;
-            current_objects = &bathroom_objects;
-            break;
-        }
-        case RoomType::Office: {
-            current_scene   = &office_scene;
-            current_objects = &office_objects;
-            break;
+// Thin or irregular things (mats, burners, the stairs) that their eight-corner bbox fits badly collide
+// with the cat through their own triangles instead; other static furniture gets the convex hull of its
+// vertices. Call before build_world_tree so proxies cover the new colliders.
+void PlayMode::build_colliders(Scene &scene, MeshBuffer const &meshes, std::vector<RoomObject> &objects) {
+    auto use_mesh = [](std::string const &name) {
+        static std::unordered_set<std::string> const names = {
+            "Rug",                                                            // living room
+            "Mat", "Spider Burner", "Spider Burner.001", "Spider Burner.002", // kitchen
+            "Spider Burner.003",
+            "Bath Mat", "Bath Mat.001",                                       // bathroom
+            "Desk Mat", "Pencil",                                             // office
+        };
+        return names.count(name) || name == "Stair" || name.rfind("Stair.", 0) == 0;
+    };
+
+    for (auto &obj : objects) {
+        auto drawable_iter = std::find_if(scene.drawables.begin(), scene.drawables.end(),
+                [&obj](const Scene::Drawable &elem) { return elem.transform == obj.transform; });
+        if (drawable_iter == scene.drawables.end()) continue;
+        glm::vec3 const *positions = meshes.positions.data() + drawable_iter->pipeline.start;
+        uint32_t count = drawable_iter->pipeline.count;
+
+        if (use_mesh(obj.name)) {
+            auto mesh = std::make_shared<MeshCollider>();
+            mesh->build(positions, count, obj.transform->make_local_to_world());
+            if (mesh->triangle_count == 0) {
+                std::cerr << "WARNING: " << obj.name << " has no triangles to collide with, keeping its bbox" << std::endl;
+                continue;
+            }
+            store.mesh[obj.id] = mesh;
+            continue;
         }
-        default: {
-            printf("ERROR (switch_room) Room Type: %d not implemented yet\n", room_type);
+
+        // hulls are baked in world space, so not for anything the cat can move:
+        if (obj.collision_type != CollisionType::None) continue;
+        auto hull = std::make_shared<ConvexHull>();
+        if (!hull->build(positions, count, obj.transform->make_local_to_world())) continue; // flat: bbox is as good
+        if (hull->vertices.size() <= 8) continue; // a box (walls, floors): the bbox test is cheaper
+        store.hull[obj.id] = hull;
+    }
+}
+
+// Moves a room's transforms and drawables into world_scene (tagged with the room) and its objects into
+// world_objects. Rooms are drawn in the order they are added.
+void PlayMode::add_room(Scene &scene, std::vector<RoomObject> &objects, RoomType room) {
+    for (auto &drawable : scene.drawables) drawable.partition = room;
+    for (auto &obj : objects) {
+        for (auto &drawable : obj.reaction_drawables) drawable.partition = room;
+    }
+    // splicing hands over the pools' chunks, so the transforms stay where they are and pointers to them stay good:
+    world_scene.transforms.splice(scene.transforms);
+    world_scene.drawables.splice(scene.drawables);
+
+    for (auto const &obj : objects) insert_world_object(obj, room);
+}
+
+void PlayMode::build_world_tree() {
+    world_tree.clear();
+    AABB area;
+    for (auto const &obj : world_objects) area = area.merged(store.world_box(obj.id));
+    for (auto const &room : room_graph.rooms) area = area.merged(room.bounds); // including rooms not loaded yet
+    world_ground.reset(area.expanded(1.0f), 1.0f);
+    for (auto const &obj : world_objects) store.insert(obj.id, &world_tree, &world_ground);
+}
+
+// adds a copy of obj at the end of room's range (not to the tree; see ObjectStore::insert)
+void PlayMode::insert_world_object(RoomObject const &obj, RoomType room) {
+    world_objects.insert(world_objects.begin() + room_begin[room + 1], obj);
+    for (uint32_t r = room + 1; r <= RoomCount; r++) room_begin[r]++;
+    store.partition[obj.id] = uint8_t(room);
+    relink_world_objects();
+}
+
+void PlayMode::erase_world_object(std::vector<RoomObject>::iterator obj) {
+    uint32_t room = store.partition[obj->id];
+    world_objects.erase(obj);
+    for (uint32_t r = room + 1; r <= RoomCount; r++) room_begin[r]--;
+    relink_world_objects();
+}
+
+// points the store's handles back at world_objects; call after it is resized
+void PlayMode::relink_world_objects() {
+    for (auto &obj : world_objects) store.object[obj.id] = &obj;
+}
+
+// Room bounds from bounds_scene, linked through the doorways collected by generate_wdfs_objects.
+void PlayMode::build_room_graph() {
+    for (auto &drawable : bounds_scene.drawables) {
+        std::string const &bound_name = drawable.transform->name;
+        RoomType room;
+        if (bound_name == "KitchenBounds") {
+            room = Kitchen;
+        } else if (bound_name == "LivingRoomBounds") {
+            room = LivingRoom;
+        } else if (bound_name == "BedroomBounds") {
+            room = Bedroom;
+        } else if (bound_name == "BathroomBounds") {
+            room = Bathroom;
+        } else if (bound_name == "OfficeBounds") {
+            room = Office;
+        } else {
+            printf("ERROR (build_room_graph) Room %s not implemented yet\n", bound_name.c_str());
             exit(1);
-            break;
         }
+        room_graph.add_room(room, AABB::from_points(drawable.transform->bbox, 8));
     }
+    room_graph.build(0.5f);
 }
 
-bool PlayMode::player_front_inside_bbox(Scene::Transform *transform) {
+void PlayMode::populate_current_rooms() {
     glm::vec3 player_front_pos = player.transform_front->make_local_to_world() * glm::vec4(player.transform_front->position, 1.0f);
-    float x_min = std::min({transform->bbox[0].x, transform->bbox[1].x, transform->bbox[2].x, transform->bbox[3].x, transform->bbox[4].x, transform->bbox[5].x, transform->bbox[6].x, transform->bbox[7].x });
-    float x_max = std::max({transform->bbox[0].x, transform->bbox[1].x, transform->bbox[2].x, transform->bbox[3].x, transform->bbox[4].x, transform->bbox[5].x, transform->bbox[6].x, transform->bbox[7].x });
-    float y_min = std::min({transform->bbox[0].y, transform->bbox[1].y, transform->bbox[2].y, transform->bbox[3].y, transform->bbox[4].y, transform->bbox[5].y, transform->bbox[6].y, transform->bbox[7].y });
-    float y_max = std::max({transform->bbox[0].y, transform->bbox[1].y, transform->bbox[2].y, transform->bbox[3].y, transform->bbox[4].y, transform->bbox[5].y, transform->bbox[6].y, transform->bbox[7].y });
-    float z_min = std::min({transform->bbox[0].z, transform->bbox[1].z, transform->bbox[2].z, transform->bbox[3].z, transform->bbox[4].z, transform->bbox[5].z, transform->bbox[6].z, transform->bbox[7].z });
-    float z_max = std::max({transform->bbox[0].z, transform->bbox[1].z, transform->bbox[2].z, transform->bbox[3].z, transform->bbox[4].z, transform->bbox[5].z, transform->bbox[6].z, transform->bbox[7].z });
-
-    // printf("room: x %f %f y %f %f z %f %f\n", x_min, x_max, y_min, y_max, z_min, z_max);
-    // printf("player: x %f y %f z %f\n", player_front_pos.x, player_front_pos.y, player_front_pos.z);
-
-    return ((player_front_pos.x <= x_max) && 
-            (player_front_pos.x >= x_min) && 
-            (player_front_pos.y <= y_max) && 
-            (player_front_pos.y >= y_min) &&
-            (player_front_pos.z <= z_max) && 
-            (player_front_pos.z >= z_min));
+    current_rooms = room_bit(WallsDoorsFloorsStairs) // always have this
+                  | room_graph.update(player_front_pos, 1.0f);
+    cat_room = WallsDoorsFloorsStairs;
+    if (!room_graph.inside.empty()) cat_room = RoomType(room_graph.rooms[room_graph.inside[0]].id);
 }
 
-void PlayMode::populate_current_rooms() {
-    current_rooms.clear();
-    current_rooms.push_back(WallsDoorsFloorsStairs); // always have this
-
-    // loop through bounds_scene and check point in axis aligned bbox
-    for (auto &drawable : bounds_scene.drawables) {
-        // printf("loop: %s\n", drawable.transform->name.c_str());
-        if (player_front_inside_bbox(drawable.transform)) {
-            std::string bound_name = drawable.transform->name;
-
-            if (bound_name == "KitchenBounds") {
-                current_rooms.push_back(Kitchen);
-            } else if (bound_name == "LivingRoomBounds") {
-                current_rooms.push_back(LivingRoom);
-            } else if (bound_name == "BedroomBounds") {
-                current_rooms.push_back(Bedroom);
-            } else if (bound_name == "BathroomBounds") {
-                current_rooms.push_back(Bathroom);
-            } else if (bound_name == "OfficeBounds") {
-                current_rooms.push_back(Office);
-            } else {
-                printf("ERROR (populate_current_rooms) Room %s not implemented yet\n", drawable.transform->name.c_str());
-                exit(1);
+// Loads the rooms within load_radius links (in room_graph) of the ones the cat is in and evicts the ones more
+// than evict_radius away. Rooms the cat is in are waited for (as are all requested ones if 'wait'); otherwise
+// loads finish in the background and are installed on a later frame.
+void PlayMode::stream_rooms(bool wait) {
+    if (!room_graph.inside.empty()) { // between rooms (e.g. on the stairs) keep what is there
+        std::vector<uint32_t> hops = room_graph.hops();
+        for (uint32_t r = 0; r < room_graph.rooms.size(); r++) {
+            RoomType room = RoomType(room_graph.rooms[r].id);
+            if (hops[r] <= load_radius) {
+                room_streamer.request(room);
+            } else if (hops[r] > evict_radius && room_streamer.loaded(room) && can_evict(room)) {
+                evict_room(room);
             }
         }
     }
+    for (uint32_t r : room_graph.inside) {
+        if (!room_streamer.loaded(room_graph.rooms[r].id)) wait = true; // jumped past the preloading
+    }
+    for (uint32_t room : room_streamer.poll(wait)) install_room(RoomType(room));
+}
+
+// Puts a room room_streamer has just loaded into the world: the first time, its objects are made and it is
+// added like the stairs were; after an eviction, what evict_room parked comes back.
+void PlayMode::install_room(RoomType room) {
+    RoomStreamer::Room &loaded = room_streamer.rooms[room];
+    if (loaded.scene) {
+        Scene &scene = *loaded.scene;
+        std::vector<RoomObject> objects;
+        GenerateBBox(scene, *loaded.meshes);
+        generate_room_objects(scene, objects, room);
+        build_colliders(scene, *loaded.meshes, objects);
+        add_room(scene, objects, room);
+        loaded.scene.reset();
+        for (auto const &obj : objects) store.insert(obj.id, &world_tree, &world_ground);
+    } else {
+        for (auto &drawable : parked_drawables[room]) {
+            drawable.pipeline.vao = loaded.vao;
+            world_scene.drawables.push_back(std::move(drawable));
+        }
+        parked_drawables[room].clear();
+        for (auto &obj : world_objects) {
+            if (obj.home != room) continue;
+            for (auto &drawable : obj.reaction_drawables) drawable.pipeline.vao = loaded.vao;
+        }
+        for (uint32_t handle : parked_objects[room]) store.insert(handle, &world_tree, &world_ground);
+        parked_objects[room].clear();
+    }
+    player_candidates_stale = true;
+}
+
+// Frees a far-away room's meshes. Its transforms and RoomObjects stay, so whatever the cat did there is still
+// done when it comes back; its drawables and tree entries are parked until install_room.
+void PlayMode::evict_room(RoomType room) {
+    // (nothing keeps pointers to world_scene's drawables, so they can be moved out and back)
+    for (auto drawable = world_scene.drawables.begin(); drawable != world_scene.drawables.end(); ) {
+        if (drawable->partition == room) {
+            parked_drawables[room].push_back(std::move(*drawable));
+            drawable = world_scene.drawables.erase(drawable);
+        } else {
+            ++drawable;
+        }
+    }
+    for (uint32_t i = room_begin[room]; i < room_begin[room + 1]; i++) {
+        uint32_t handle = world_objects[i].id;
+        if (!store.in_room(handle)) continue; // already out of play (see pseudo_remove_bbox)
+        store.remove(handle);
+        parked_objects[room].push_back(handle);
+    }
+    room_streamer.evict(room);
+    player_candidates_stale = true;
+}
+
+// a room's meshes are needed while anything from it is somewhere else (carried, or put down in another room)
+bool PlayMode::can_evict(RoomType room) const {
+    for (auto const &obj : player.held_obj) {
+        if (obj.home == room) return false;
+    }
+    for (uint32_t i = 0; i < world_objects.size(); i++) {
+        if (world_objects[i].home == room && (i < room_begin[room] || i >= room_begin[room + 1])) return false;
+    }
+    return true;
 }
 
 PlayMode::PlayMode() : 
     shadow_scene(*shadow_scene_load), 
     cat_scene(*cat_scene_load), 
-    living_room_scene(*living_room_scene_load), 
-    kitchen_scene(*kitchen_scene_load),
-    wdfs_scene(*walls_doors_floors_stairs_scene_load),
-    bedroom_scene(*bedroom_scene_load),
-    bathroom_scene(*bathroom_scene_load),
-    office_scene(*office_scene_load),
     bounds_scene(*bounds_scene_load) {
     
-    GenerateBBox(cat_scene, cat_meshes);
-    GenerateBBox(bounds_scene, bounds_meshes);
+    GenerateBBox(cat_scene, *cat_meshes);
+    GenerateBBox(bounds_scene, *bounds_meshes);
 
     // remove player capsule from being drawn
     RemoveFrameByName(cat_scene, "Player");
@@ -1052,45 +993,60 @@ PlayMode::PlayMode() :
     GetFrames(cat_scene, player_up_jump, "UpJump");
     GetFrames(cat_scene, player_down_jump, "DownJump");
     GetFrames(cat_scene, player_swat, "Swat");
+    for (Animation *animation : {&player_walking, &player_up_jump, &player_down_jump}) {
+        for (auto const *frame : animation->frames) animation->mouth.push_back(mouth_pos[frame->transform->name]);
+    }
+    for (Animation *animation : {&player_walking, &player_up_jump, &player_down_jump, &player_swat}) {
+        MorphFrames(*animation, *cat_meshes);
+    }
 
-    // remove held items from scene
-    bool done = false;
-    while (!done) {
-        auto frame_iter = find_if(cat_scene.drawables.begin(), cat_scene.drawables.end(),
-                                [](const Scene::Drawable & elem) { return elem.transform->name.find("Mouth") != std::string::npos; });
-        if (frame_iter == cat_scene.drawables.end()) {
-            done = true;
-        } else {
-            player_held_items.push_back(*frame_iter);
-            cat_scene.drawables.erase(frame_iter);
-        }
+    // held items
+    for (auto &drawable : cat_scene.drawables) {
+        std::string const &name = drawable.transform->name;
+        size_t suffix = name.find(" Mouth");
+        if (suffix != std::string::npos) player_held_items[name.substr(0, suffix)] = &drawable;
+    }
+
+    // of the keyframes and held items, only the current frame (and whatever is in the cat's mouth) is drawn;
+    // anything else in cat.scene (e.g. CatShadow) stays as it is
+    for (Animation *animation : {&player_walking, &player_up_jump, &player_down_jump, &player_swat}) {
+        for (auto *frame : animation->frames) frame->hidden = true;
     }
+    for (auto &item : player_held_items) item.second->hidden = true;
 
     // start cat with Walk0 fame
-    AddFrame(cat_scene, player_walking.frames[0]);
+    player_walking.show(cat_animation);
 
     if (cat_scene.cameras.size() != 1) throw std::runtime_error("Expecting scene to have exactly one camera, but it has " + std::to_string(cat_scene.cameras.size()));
 	player.camera = &cat_scene.cameras.front();
 
-    GenerateBBox(living_room_scene, living_room_meshes);
-    GenerateBBox(kitchen_scene, kitchen_meshes);
-    GenerateBBox(wdfs_scene, walls_doors_floors_stairs_meshes);
-    GenerateBBox(bedroom_scene, bedroom_meshes);
-    GenerateBBox(bathroom_scene, bathroom_meshes);
-    GenerateBBox(office_scene, office_meshes);
-
-    generate_room_objects(living_room_scene, living_room_objects, RoomType::LivingRoom);
-    generate_room_objects(kitchen_scene, kitchen_objects, RoomType::Kitchen);
+    // the walls, floors and stairs are always there and say where the doorways are:
+    Scene wdfs_scene(*walls_doors_floors_stairs_scene_load);
+    std::vector<RoomObject> wdfs_objects;
+    GenerateBBox(wdfs_scene, *walls_doors_floors_stairs_meshes);
     generate_room_objects(wdfs_scene, wdfs_objects, RoomType::WallsDoorsFloorsStairs);
-    generate_room_objects(bedroom_scene, bedroom_objects, RoomType::Bedroom);
-    generate_room_objects(bathroom_scene, bathroom_objects, RoomType::Bathroom);
-    generate_room_objects(office_scene, office_objects, RoomType::Office);
-
-    // ----- Start in living room -----
-    switch_rooms(RoomType::LivingRoom);
+    build_colliders(wdfs_scene, *walls_doors_floors_stairs_meshes, wdfs_objects);
+    add_room(wdfs_scene, wdfs_objects, RoomType::WallsDoorsFloorsStairs);
+    build_room_graph();
+    build_world_tree();
+
+    // the rooms themselves are loaded around the cat (and drawn in the order they arrive)
+    room_streamer.pipeline = lit_color_texture_program_pipeline;
+    room_streamer.program = lit_color_texture_program->program;
+    room_streamer.add_room(LivingRoom, "living_room");
+    room_streamer.add_room(Kitchen, "kitchen");
+    room_streamer.add_room(Bedroom, "bedroom");
+    room_streamer.add_room(Bathroom, "bathroom");
+    room_streamer.add_room(Office, "office");
+    populate_current_rooms();
+    if (room_graph.inside.empty()) {
+        // starting between rooms: nothing to measure the distance from yet, so have them all
+        for (auto const &room : room_graph.rooms) room_streamer.request(room.id);
+    }
+    stream_rooms(true);
 
     // Get shadow transform 
-    auto shadow_iter = find_if(shadow_scene.drawables.begin(), shadow_scene.drawables.end(),
+    auto shadow_iter = std::find_if(shadow_scene.drawables.begin(), shadow_scene.drawables.end(),
                                         [](const Scene::Drawable &elem) { return elem.transform->name == "Shadow"; });
     if (shadow_iter != shadow_scene.drawables.end()) {
         shadow.drawable = &(*shadow_iter);
@@ -1201,145 +1157,233 @@ SurfaceType get_top_surface_type(Scene::Transform *transform) {
     }
 }
 
-std::string PlayMode::capsule_collide(RoomObject &current_obj, glm::vec3 *pen_normal, float *pen_depth) {
-    for (auto room_type : current_rooms) {
-        switch_rooms(room_type);
-        for (auto obj : *current_objects) {
-            // if (obj.name == "Rug") continue; // Rug is kinda blocky      
-            if (obj.name == current_obj.name) continue;
+uint32_t PlayMode::capsule_collide(RoomObject &current_obj, glm::vec3 *pen_normal, float *pen_depth) {
+    auto capsule = current_obj.capsule;
+    AABB capsule_box = AABB::around_segment(capsule.tip, capsule.base, capsule.radius);
+
+    uint32_t hit = ObjectStore::NoObject;
+    world_tree.query(capsule_box, [&](uint32_t handle) {
+        if (handle == current_obj.id || !store.in_partitions(handle, current_rooms)) return true;
+        if (!(store.category[handle] & current_obj.mask)) return true;
+
+        CollisionResult result;
+        if (store.capsule_collision(handle, capsule.tip, capsule.base, capsule.radius, &result)) {
+            *pen_normal = result.normal;
+            *pen_depth = result.depth;
+            hit = handle;
+            return false;
+        }
+        return true;
+    });
+    return hit;
+}
 
-            auto capsule = current_obj.capsule;
-            SurfaceType surface;
+// Moves current_obj's capsule along 'motion' and returns the first object it would touch (NoObject if none),
+// with *toi = the fraction of 'motion' that can be covered before touching it.
+uint32_t PlayMode::capsule_sweep(RoomObject &current_obj, glm::vec3 motion, float *toi) {
+    auto capsule = current_obj.capsule;
+    AABB capsule_box = AABB::around_segment(capsule.tip, capsule.base, capsule.radius);
+    AABB sweep_box = capsule_box.merged(AABB(capsule_box.min + motion, capsule_box.max + motion));
+
+    uint32_t hit = ObjectStore::NoObject;
+    *toi = 1.0f;
+    world_tree.query(sweep_box, [&](uint32_t handle) {
+        if (handle == current_obj.id || !store.in_partitions(handle, current_rooms)) return true;
+        if (!(store.category[handle] & current_obj.mask)) return true;
+
+        CollisionResult result;
+        float t;
+        if (store.capsule_sweep(handle, capsule.tip, capsule.base, capsule.radius, motion, &t, &result) && t < *toi) {
+            *toi = t;
+            hit = handle;
+        }
+        return true;
+    });
+    return hit;
+}
 
-            if (capsule_bbox_collision(capsule.tip, capsule.base, capsule.radius, obj.transform->bbox, &surface, pen_normal, pen_depth)) {
-                return obj.name;
-            }
-        }
-    }
-    return "";
+bool PlayMode::raycast(glm::vec3 origin, glm::vec3 dir, float max_t, uint32_t skip, RayHit *hit) {
+    hit->object = -1U;
+    world_tree.raycast(origin, dir, max_t, [&](uint32_t handle, float max_t_) {
+        if (!store.in_partitions(handle, current_rooms) || (store.flags[handle] & skip)) return max_t_;
+        float t;
+        if (!ray_obb_intersection(origin, dir, max_t_, store.obb[handle], &t)) return max_t_;
+        hit->t = t;
+        hit->object = handle;
+        return t;
+    });
+    return hit->object != -1U;
 }
 
-std::string PlayMode::paw_collide() {
-   for (auto room_type : current_rooms) {
-        switch_rooms(room_type);
-
-        for (auto obj : *current_objects) {
-            if (obj.collision_type != CollisionType::Steal && obj.collision_type != CollisionType::Destroy) continue;
-
-            glm::vec3 paw_tip = player.paw->make_local_to_world() * glm::vec4(player.paw->position, 1.0f);
-            glm::vec3 paw_base = paw_tip;
-            paw_base.z += 1.0f;
-            paw_tip.z -= 1.0f;
-            // temps are throw aways
-            SurfaceType temp_surface;
-            glm::vec3 temp_pen_normal;
-            float temp_pen_depth;
-            if (capsule_bbox_collision(paw_tip, paw_base, player.radius, obj.transform->bbox, &temp_surface, &temp_pen_normal, &temp_pen_depth)) {
-                return obj.name;
-            }
-        }
+uint32_t PlayMode::paw_collide() {
+    glm::vec3 paw_tip = player.paw->make_local_to_world() * glm::vec4(player.paw->position, 1.0f);
+    glm::vec3 paw_base = paw_tip;
+    paw_base.z += 1.0f;
+    paw_tip.z -= 1.0f;
+    AABB paw_box = AABB::around_segment(paw_tip, paw_base, player.radius);
+
+    uint32_t hit = ObjectStore::NoObject;
+    world_tree.query(paw_box, [&](uint32_t handle) {
+        if (!store.in_partitions(handle, current_rooms) || !(store.category[handle] & PawMask)) return true;
+
+        CollisionResult result; // only the hit matters here
+        if (store.capsule_collision(handle, paw_tip, paw_base, player.radius, &result)) {
+            hit = handle;
+            return false;
+        }
+        return true;
+    });
+    return hit;
+}
 
+// the cat is two capsules: one at the front of the cat, one in the middle
+void PlayMode::player_capsules(CapsuleCollider capsules[2]) {
+    // printf("transform_front: %f %f %f\n", player.transform_front->position.x, player.transform_front->position.y, player.transform_front->position.z);
+    glm::vec3 front_tip = player.transform_front->make_local_to_world() * glm::vec4(player.transform_front->position, 1.0f);
+    glm::vec3 front_base = front_tip;
+    front_tip.z += 1.0f;
+    front_base.z -= 1.0f;
+    capsules[0].tip = front_tip;
+    capsules[0].base = front_base;
+    capsules[0].radius = player.radius;
+
+    glm::vec3 middle_tip = player.transform_middle->position;
+    middle_tip.z += 1.0f;
+    glm::vec3 middle_base = player.transform_middle->position;
+    middle_base.z -= 1.0f;
+    capsules[1].tip = middle_tip;
+    capsules[1].base = middle_base;
+    capsules[1].radius = player.radius;
+}
+
+// One broadphase pass for all of this frame's player collision checks: the box covers the cat's
+// capsules, the slide after a sideways hit and 'fall' (this frame's gravity step) below.
+void PlayMode::gather_player_candidates(float fall) {
+    CapsuleCollider capsules[2];
+    player_capsules(capsules);
+    float slide = player.radius + 0.3f;
+    AABB box = AABB::around_segment(capsules[0].tip, capsules[0].base, capsules[0].radius)
+                .merged(AABB::around_segment(capsules[1].tip, capsules[1].base, capsules[1].radius))
+                .expanded(slide);
+    box.min.z -= fall;
+
+    player_candidates.clear();
+    player_candidate_box = box;
+    player_candidates_stale = false;
+
+    world_tree.query(box, [&](uint32_t handle) {
+        if (!store.in_partitions(handle, current_rooms) || !(store.category[handle] & PlayerMask)) return true;
+        player_candidates.push_back(handle);
+        return true;
+    });
+}
+
+// Narrowphase for the cat's capsules against the gathered candidates; contacts come back deepest first.
+void PlayMode::collide_player(std::vector<Contact> *contacts, CollisionDebug *debug) {
+    CapsuleCollider capsules[2];
+    player_capsules(capsules);
+
+    AABB player_box = AABB::around_segment(capsules[0].tip, capsules[0].base, capsules[0].radius)
+                        .merged(AABB::around_segment(capsules[1].tip, capsules[1].base, capsules[1].radius));
+    if (player_candidates_stale || !player_candidate_box.contains(player_box)) {
+        gather_player_candidates(0.f);
     }
-    return "";
+
+    contacts->clear();
+    for (uint32_t h : player_candidates) {
+        if (!store.in_room(h)) continue; // removed from its room since the candidates were gathered
+        if (!store.bounds[h].overlaps(player_box)) continue;
+        if (store.mesh[h]) compound_mesh_contacts(capsules, 2, *store.mesh[h], h, contacts, debug);
+        else if (store.hull[h]) compound_hull_contacts(capsules, 2, *store.hull[h], h, contacts);
+        else compound_bbox_contacts(capsules, 2, store.obb[h], h, contacts, &player_contact_cache, 0, debug);
+    }
+    sort_contacts(contacts);
 }
 
-Scene::Transform *PlayMode::collide() {
-    num_collide_objs = 0;
-    SurfaceType surface;
+// Fraction of 'motion' the cat's capsules can move through the gathered candidates before touching one
+// (1 if nothing is in the way); contacts the cat is already in and not moving further into don't stop it.
+float PlayMode::sweep_player(glm::vec3 motion) {
+    CapsuleCollider capsules[2];
+    player_capsules(capsules);
+
+    float toi = 1.0f;
+    for (uint32_t h : player_candidates) {
+        if (!store.in_room(h)) continue;
+        for (auto const &capsule : capsules) {
+            CollisionResult result;
+            float t;
+            if (store.capsule_sweep(h, capsule.tip, capsule.base, capsule.radius, motion, &t, &result)) toi = std::min(toi, t);
+        }
+    }
+    return toi;
+}
 
-    Scene::Transform *collide_obj = nullptr;
+uint32_t PlayMode::collide(CollisionDebug *debug) {
+    collide_player(&player_contacts, debug);
+    num_collide_objs = int(player_contacts.size());
 
-    // save the vector that is most like (0, 0, 1)
+    // resolve against the contact that is most like (0, 0, 1), else the deepest
     // save that collision into penetration_normal, penetration_depth
-    glm::vec3 best_pen_normal = glm::vec3(0.f);
-    float best_pen_depth = 0.f;
-
-    for (auto room_type : current_rooms) {
-        switch_rooms(room_type);
-
-        for (auto obj : *current_objects) {
-            // skip over thin/small things
-            // living room
-            if (obj.name == "Rug") continue;
-
-            // kitchen
-            if (obj.name == "Mat") continue;
-            if (obj.name == "Spider Burner") continue;
-            if (obj.name == "Spider Burner.001") continue;
-            if (obj.name == "Spider Burner.002") continue;
-            if (obj.name == "Spider Burner.003") continue;
-
-            // bathroom
-            if (obj.name == "Bath Mat") continue;
-            if (obj.name == "Bath Mat.001") continue;
-
-            // office
-            if (obj.name == "Desk Mat") continue;
-            if (obj.name == "Pencil") continue;
-
-            if (obj.collision_type == CollisionType::Steal) continue;
-            // printf("transform_front:.....\n");
-            // printf("transform_front: %f %f %f\n", player.transform_front->position.x, player.transform_front->position.y, player.transform_front->position.z);
-            glm::vec3 player_tip = player.transform_front->make_local_to_world() * glm::vec4(player.transform_front->position, 1.0f);
-            glm::vec3 player_base = player_tip;
-            player_tip.z += 1.0f;
-            player_base.z -= 1.0f;
-            if (capsule_bbox_collision(player_tip, player_base, player.radius, obj.transform->bbox, &surface, &penetration_normal, &penetration_depth)) {
-                // printf("collided with: %s\n", obj.name.c_str());
-                num_collide_objs++;
-                collide_obj = obj.transform;
-                if (num_collide_objs == 1 || is_almost_up_vec(penetration_normal)) {
-                    best_pen_normal = penetration_normal;
-                    best_pen_depth = penetration_depth;
-                }
-            }
+    int32_t primary = primary_contact(player_contacts);
+    if (primary < 0) {
+        penetration_normal = glm::vec3(0.f);
+        penetration_depth = 0.f;
+        return ObjectStore::NoObject;
+    }
+    CollisionResult const &result = player_contacts[primary].result;
+    penetration_normal = result.normal;
+    penetration_depth = result.depth;
 
-            player_tip = player.transform_middle->position;
-            player_tip.z += 1.0f;
-            player_base = player.transform_middle->position;
-            player_base.z -= 1.0f;
-            if (capsule_bbox_collision(player_tip, player_base, player.radius, obj.transform->bbox, &surface, &penetration_normal, &penetration_depth)) {
-                num_collide_objs++;
-                collide_obj = obj.transform;
-                if (num_collide_objs == 1 || is_almost_up_vec(penetration_normal)) {
-                    best_pen_normal = penetration_normal;
-                    best_pen_depth = penetration_depth;
-                }
-            }
-        }
+    return result.object_id;
+}
 
+void PlayMode::gather_awake_bodies() {
+    awake_bodies.clear();
+    for (uint32_t room = 0; room < RoomCount; room++) {
+        if (!(current_rooms & room_bit(RoomType(room)))) continue;
+        for (uint32_t i = room_begin[room]; i < room_begin[room + 1]; i++) {
+            RoomObject const &obj = world_objects[i];
+            if (obj.has_body() && obj.body.awake && store.in_room(obj.id)) awake_bodies.push_back(obj.id);
+        }
     }
+    awake_bodies_rooms = current_rooms;
+}
 
-    penetration_normal = best_pen_normal;
-    penetration_depth = best_pen_depth;
+void PlayMode::wake_body(uint32_t handle) {
+    RoomObject *obj = store.object[handle];
+    if (!obj || obj->body.awake) return;
+    obj->body.wake();
+    awake_bodies.push_back(handle);
+}
 
-    return collide_obj;
+// wakes the sleeping bodies touching 'box' (e.g. the old box of something that moved or went away)
+void PlayMode::wake_bodies_near(AABB const &box) {
+    world_tree.query(box, [&](uint32_t handle) {
+        if (store.in_partitions(handle, current_rooms) && store.object[handle]->has_body()) wake_body(handle);
+        return true;
+    });
 }
 
 // ROOM OBJECTS COLLISION AND MOVEMENT START ------------------------
-void PlayMode::interact_with_objects(float elapsed, std::string object_collide_name, glm::vec3 player_motion) {
+void PlayMode::interact_with_objects(float elapsed, uint32_t object_collide, glm::vec3 player_motion) {
 
     auto switchout_mesh = [&](RoomObject &resolved_obj) {        
         // std::cout << "===> Pos-collision, adding back " << resolved_obj.reaction_drawables[0].transform->name << std::endl;
 
         // First delete resolved object's mesh
-        // TODO: use RemoveframeByName when current_scene is being used to differentiate collisions between rooms
-        bool deleted = false;
-        for (auto room_type : current_rooms) {
-            switch_rooms(room_type);
-            if (RemoveFrameByName(*current_scene, resolved_obj.name)) {
-                current_scene->drawables.push_back(resolved_obj.reaction_drawables[0]);
-                deleted = true;
-                break;
-            }
-        }
-
-        if (!deleted) {
+        auto drawable_iter = std::find_if(world_scene.drawables.begin(), world_scene.drawables.end(),
+                [&resolved_obj](const Scene::Drawable &elem) { return elem.transform == resolved_obj.transform; });
+        if (drawable_iter != world_scene.drawables.end()) {
+            world_scene.drawables.erase(drawable_iter);
+            world_scene.drawables.push_back(resolved_obj.reaction_drawables[0]);
+        } else {
             std::cerr << "ERROR: Cannot locate current object drawable: " << resolved_obj.name << std::endl;
         }
     };
 
     auto pseudo_remove_bbox = [&](RoomObject &removed_obj) {
+        // anything resting on it has lost its support:
+        if (store.in_room(removed_obj.id)) wake_bodies_near(store.bounds[removed_obj.id]);
         // Save current bounding box
         for (auto i = 0; i < 8; i++) {
             // removed_obj.orig_bbox[i] = removed_obj.transform->bbox[i];
@@ -1348,6 +1392,8 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
         // Move capsule tip and base, to be reset later (TODO: write a class helper that does this)
         removed_obj.capsule.tip = glm::vec3(-10000);
         removed_obj.capsule.base = glm::vec3(-10000);
+        // and take it out of the broadphase
+        store.remove(removed_obj.id);
     };
 
     auto restore_removed_bbox = [&](RoomObject &removed_obj) {
@@ -1355,19 +1401,20 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
         for (auto i = 0; i < 8; i++) {
             removed_obj.transform->bbox[i] = removed_obj.orig_bbox[i] + (removed_obj.transform->position - removed_obj.orig_pos);
         }
+        store.refit(removed_obj.id);
     };
 
     // check for paw
     if (swat.pressed) {
         if (player.swatting && !player.holding) {
-            std::string swat_obj_name = paw_collide();
-            if (swat_obj_name != "") {
-                object_collide_name = swat_obj_name;
+            uint32_t swat_obj = paw_collide();
+            if (swat_obj != ObjectStore::NoObject) {
+                object_collide = swat_obj;
             }
         } else if (player.swatting && player.holding) {
             // put item down
             // printf("putting down %s\n", player.held_obj->transform->name.c_str());
-            object_collide_name = "";
+            object_collide = ObjectStore::NoObject;
             glm::vec3 abs_transform_front_pos = player.transform_front->make_local_to_world() * glm::vec4(player.transform_front->position, 1.0f);
             glm::vec3 t_offset = abs_transform_front_pos - player.transform_middle->position;
             t_offset.z = 0.f;
@@ -1375,19 +1422,13 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
             player.held_obj[0].transform->position = abs_transform_front_pos + (t_offset * 0.2f);
             player.held_obj[0].transform->position += glm::vec3(0.f, 0.f, 0.6f);
 
-            // put object in current_object
-            if (current_rooms.size() == 0) {
-                printf("ERROR: current_rooms size is 0\n");
-            } else if (current_rooms.size() == 1) {
-                // on stairs area
-                switch_rooms(current_rooms[0]);
-                current_objects->push_back(player.held_obj[0]);
-            } else {
-                switch_rooms(current_rooms[1]);
-                current_objects->push_back(player.held_obj[0]);   
-            }
-            
+            // put object in the room the cat is in (the stairs if no other)
             restore_removed_bbox(player.held_obj[0]);
+            uint32_t handle = player.held_obj[0].id;
+            insert_world_object(player.held_obj[0], cat_room);
+            store.insert(handle, &world_tree, &world_ground);
+            wake_body(handle);
+            player_candidates_stale = true;
             player.held_obj.clear();
             player.holding = false;
         }
@@ -1397,28 +1438,15 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
     // player has picked up object
     bool found_object = false;
     std::vector<RoomObject>::iterator collision_obj_iter;
-    for (auto room_type : current_rooms) {
-        switch_rooms(room_type);
-        collision_obj_iter = find_if((*current_objects).begin(), (*current_objects).end(),
-                                        [object_collide_name](const RoomObject &elem) { return elem.name == object_collide_name; });
-        if (collision_obj_iter != (*current_objects).end()) {
-            found_object = true;
-            break;
-        }
+    if (object_collide != ObjectStore::NoObject && store.object[object_collide]
+            && store.in_partitions(object_collide, current_rooms)) {
+        collision_obj_iter = world_objects.begin() + (store.object[object_collide] - world_objects.data());
+        found_object = true;
     }
 
     if (found_object) {
         RoomObject &collision_obj = *(collision_obj_iter);
-
-        // parse out every including and past . in the name
-        size_t period_pos = 0;
-        //SOURCE: https://stackoverflow.com/questions/14265581/parse-split-a-string-in-c-using-string-delimiter-standard-c
-        std::string parsed_name = "";
-
-        parsed_name = collision_obj.transform->name;
-        if ((period_pos = collision_obj.transform->name.find(".")) != std::string::npos) {
-            parsed_name = collision_obj.transform->name.substr(0, period_pos);;
-        }
+        std::string parsed_name = collision_obj.label;
 
         switch (collision_obj.collision_type) {
             case CollisionType::Steal: {
@@ -1433,8 +1461,16 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
                 player.swatting = false;
                 player.swatting_timer = 0.f;
 
+                wake_bodies_near(store.bounds[collision_obj.id]);
+                store.remove(collision_obj.id);
+                store.object[collision_obj.id] = nullptr; // held: only player.held_obj has it now
+                collision_obj.body.sleep(); // until it is put down again
                 player.held_obj.push_back(collision_obj);
                 player.holding = true;
+                { // the mouth frame to show, found once here rather than by name every frame
+                    auto item = player_held_items.find(collision_obj.label);
+                    player.held_obj.back().held_drawable = (item != player_held_items.end() ? item->second : nullptr);
+                }
 
                 // Save current scale
                 // collision_obj.orig_scale = collision_obj.transform->scale;
@@ -1444,7 +1480,7 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
                 collision_obj.transform->position = glm::vec3(-10000);
                 pseudo_remove_bbox(collision_obj);
                 // remove obj from scene it is in
-                current_objects->erase(collision_obj_iter);
+                erase_world_object(collision_obj_iter);
 
                 break;
             }
@@ -1485,11 +1521,10 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
             case CollisionType::PushOff: {
                 if (collision_obj.done) break;
                 if (glm::length(player_motion) > 0.f) {
-                    collision_obj.move_dir = glm::normalize(player_motion);
-                    collision_obj.move_dir.z = 0.f;
-                    collision_obj.is_moving = true;
-                    collision_obj.speed = collision_obj.given_speed;
-                    // printf("dir x:%f y:%f z:%f\n", collision_obj.move_dir.x, collision_obj.move_dir.y, collision_obj.move_dir.z);
+                    glm::vec3 move_dir = glm::normalize(player_motion);
+                    move_dir.z = 0.f;
+                    collision_obj.body.velocity = move_dir * collision_obj.given_speed;
+                    wake_body(collision_obj.id);
                 }
                 break;
             }
@@ -1501,129 +1536,120 @@ void PlayMode::interact_with_objects(float elapsed, std::string object_collide_n
     
 
     // ##################### Resolve remaining collision behavior #####################
-    // simulate object motion
-    for (auto room_type : current_rooms) {
-        switch_rooms(room_type);
-
-        for (auto &obj : *current_objects) {
-            if (isnan(obj.transform->position.x) || isnan(obj.transform->position.y) || isnan(obj.transform->position.z)) {
-                printf("ERROR: OBJECT IS NAN: %s %f %f %f\n", obj.transform->name.c_str(), obj.transform->position.x, obj.transform->position.y, obj.transform->position.z);
-                continue;
-                // exit(1);
+    // simulate object motion (sleeping bodies are not visited at all)
+    if (awake_bodies_rooms != current_rooms) gather_awake_bodies();
+    // (indexed: bodies woken during the loop are appended and stepped this frame too)
+    for (size_t i = 0; i < awake_bodies.size(); i++) {
+        uint32_t handle = awake_bodies[i];
+        if (!store.in_room(handle)) continue; // gone since it was listed
+        RoomObject &obj = *store.object[handle];
+        if (!obj.body.awake || !obj.has_body()) continue;
+        if (isnan(obj.transform->position.x) || isnan(obj.transform->position.y) || isnan(obj.transform->position.z)) {
+            printf("ERROR: OBJECT IS NAN: %s %f %f %f\n", obj.transform->name.c_str(), obj.transform->position.x, obj.transform->position.y, obj.transform->position.z);
+            continue;
+            // exit(1);
+        }
+        glm::vec3 start_position = obj.transform->position;
+        AABB start_box = store.bounds[handle];
+
+        if (obj.collision_type == CollisionType::PushOff) {
+            // execute horizontal movement
+            obj.transform->position += obj.body.integrate(elapsed);
+            obj.capsule.tip = obj.transform->position;
+            obj.capsule.tip.z += obj.capsule.height/2;
+            obj.capsule.base = obj.transform->position;
+            obj.capsule.base.z  -= obj.capsule.height/2;
+
+            // check if horizontal movement caused collision
+            uint32_t horizontal_collision = capsule_collide(obj, &obj.pen_dir, &obj.pen_depth);
+            if (horizontal_collision != ObjectStore::NoObject) {
+                obj.body.bounce(obj.pen_dir);
+
+                glm::vec3 offset = ((obj.pen_depth + 0.1f) * obj.pen_dir);
+                offset.z = 0.f;
+                obj.transform->position += offset;
             }
-
-            if (obj.collision_type == CollisionType::PushOff && !obj.done) {
-                // execute horizontal movement
-                obj.transform->position += obj.move_dir * elapsed * obj.speed;
-                obj.capsule.tip = obj.transform->position;
-                obj.capsule.tip.z += obj.capsule.height/2;
-                obj.capsule.base = obj.transform->position;
-                obj.capsule.base.z  -= obj.capsule.height/2;
-
-                obj.speed -= elapsed * 5.0f;
-                if (obj.speed < 0.01f) {
-                    obj.speed = 0.f;
-                }
-
-                // check if horizontal movement caused collision
-                std::string horizontal_collision_name = capsule_collide(obj, &obj.pen_dir, &obj.pen_depth);
-                if (horizontal_collision_name != "") {
-                    // reflect
-                    obj.move_dir = glm::normalize(obj.pen_dir);
-                    
-                    glm::vec3 offset = ((obj.pen_depth + 0.1f) * obj.pen_dir);
-                    offset.z = 0.f;
-                    obj.transform->position += offset;
-                }
-
-                 // gravity - break if hits floor
-                obj.transform->position.z -= elapsed * 6.0f;
-                obj.capsule.tip = obj.transform->position;
-                obj.capsule.tip.z += obj.capsule.height/2;
-                obj.capsule.base = obj.transform->position;
-                obj.capsule.base.z  -= obj.capsule.height/2;
-
-                bool call_restore = true;
-                std::string vertical_collision_name = capsule_collide(obj, &obj.pen_dir, &obj.pen_depth);
-                if (vertical_collision_name != "") {
-                    if (std::abs(obj.orig_pos.z - obj.transform->position.z) > 1.0f) {
-                        // fell alot
-                        score += 7;
-                        // parse out every including and past . in the name
-                        size_t period_pos = 0;
-                        //SOURCE: https://stackoverflow.com/questions/14265581/parse-split-a-string-in-c-using-string-delimiter-standard-c
-                        std::string parsed_name = obj.transform->name;
-                        if ((period_pos = obj.transform->name.find(".")) != std::string::npos) {
-                            parsed_name = obj.transform->name.substr(0, period_pos);;
-                        }
-                        collide_label = "+7 " + parsed_name;
-                        collide_msg_time = 3.0f;
-                        obj.collided = true;  // prevents user from gaining more points
-                        obj.done = true;
-                        obj.transform->rotation = obj.orig_rotation;
-
-                        switchout_mesh(obj);
-                        pseudo_remove_bbox(obj);
-                        call_restore = false;
-                        if(obj.has_sound) {
-                            Sound::play(*(*(obj.samples[0])), 1.0f, 0.0f);
-                        }
-                    } else {
-                        // hasn't fallen that much - undo grav
-                        obj.transform->position += ((obj.pen_depth + 0.00001f) * obj.pen_dir);
-                    }
-                } else {
-                    // give object some rotation
-                    if (obj.spin && std::abs(obj.orig_pos.z - obj.transform->position.z) > 0.1f) {
-                        obj.transform->rotation *= glm::angleAxis(9.0f * elapsed, glm::vec3(0, 1, 0));
-                        obj.transform->rotation *= glm::angleAxis(9.0f * elapsed, glm::vec3(1, 0, 0));
-                        obj.transform->rotation *= glm::angleAxis(9.0f * elapsed, glm::vec3(0, 0, 1));
+        } else if (player.holding && player.held_obj[0].id == obj.id) {
+            continue;
+        }
+
+        // gravity - stops on the first surface below
+        // (swept, so a fast fall stops on the first surface below instead of passing through it)
+        obj.capsule.tip = obj.transform->position;
+        obj.capsule.tip.z += obj.capsule.height/2;
+        obj.capsule.base = obj.transform->position;
+        obj.capsule.base.z  -= obj.capsule.height/2;
+
+        float fall_toi;
+        glm::vec3 fall = glm::vec3(0.f, 0.f, -elapsed * obj.body.fall_speed);
+        uint32_t vertical_collision = capsule_sweep(obj, fall, &fall_toi);
+        uint32_t landed_on = vertical_collision != ObjectStore::NoObject ? store.category[vertical_collision] : 0;
+        obj.transform->position += fall_toi * fall;
+        obj.capsule.tip += fall_toi * fall;
+        obj.capsule.base += fall_toi * fall;
+
+        bool call_restore = true;
+        if (obj.collision_type == CollisionType::PushOff) {
+            if (vertical_collision != ObjectStore::NoObject) {
+                if (std::abs(obj.orig_pos.z - obj.transform->position.z) > 1.0f) {
+                    // fell alot
+                    score += 7;
+                    collide_label = "+7 " + obj.label;
+                    collide_msg_time = 3.0f;
+                    obj.collided = true;  // prevents user from gaining more points
+                    obj.done = true;
+                    obj.transform->rotation = obj.orig_rotation;
+
+                    switchout_mesh(obj);
+                    pseudo_remove_bbox(obj);
+                    call_restore = false;
+                    if(obj.has_sound) {
+                        Sound::play(*(*(obj.samples[0])), 1.0f, 0.0f);
                     }
                 }
-
-                if (call_restore) {
-                    // update bbox with new_pos - orig_pos
-                    restore_removed_bbox(obj);
+                // else hasn't fallen that much - already resting where the sweep stopped
+            } else {
+                // give object some rotation
+                if (obj.spin && std::abs(obj.orig_pos.z - obj.transform->position.z) > 0.1f) {
+                    obj.transform->rotation *= glm::angleAxis(9.0f * elapsed, glm::vec3(0, 1, 0));
+                    obj.transform->rotation *= glm::angleAxis(9.0f * elapsed, glm::vec3(1, 0, 0));
+                    obj.transform->rotation *= glm::angleAxis(9.0f * elapsed, glm::vec3(0, 0, 1));
                 }
+            }
+        } else if (landed_on & (RoomObject::ToyBin | RoomObject::Drain)) {
+            if (landed_on & RoomObject::ToyBin) {
+                Sound::play(*(*(&meow)), 1.0f, 0.0f);
+                score += 10;
+                collide_label = "+10 New Toy";
+            } else {
+                Sound::play(*(*(&splash)), 1.0f, 0.0f);
+                score += 12;
+                collide_label = "+12 Splash";
+            }
+            collide_msg_time = 3.0f;
+            display_collide = true;
+            obj.transform->position = glm::vec3(1000.f);
+            obj.body.sleep(); // out of play, nothing to fall onto out there
+        }
 
+        if (call_restore) {
+            // update bbox with new_pos - orig_pos
+            restore_removed_bbox(obj);
+        }
 
-            } else if (obj.collision_type == CollisionType::Steal) {
-                if (!player.holding || (player.held_obj[0].transform->name != obj.transform->name)) {
-                    // gravity
-                    glm::vec3 orig_pos = obj.transform->position;
-
-                    obj.transform->position.z -= elapsed * 6.0f;
-                    obj.capsule.tip = obj.transform->position;
-                    obj.capsule.tip.z += obj.capsule.height/2;
-                    obj.capsule.base = obj.transform->position;
-                    obj.capsule.base.z  -= obj.capsule.height/2;
-
-                    std::string vertical_collision_name = capsule_collide(obj, &obj.pen_dir, &obj.pen_depth);
-                    if (vertical_collision_name != "") {
-                        if (vertical_collision_name == "Cat Bed") {
-                            Sound::play(*(*(&meow)), 1.0f, 0.0f);
-                            score += 10;
-                            collide_label = "+10 New Toy";
-                            collide_msg_time = 3.0f;
-                            display_collide = true;
-                            obj.transform->position = glm::vec3(1000.f);
-                        } else if (vertical_collision_name == "Toilet.002") {
-                            Sound::play(*(*(&splash)), 1.0f, 0.0f);
-                            score += 12;
-                            collide_label = "+12 Splash";
-                            collide_msg_time = 3.0f;
-                            display_collide = true;
-                            obj.transform->position = glm::vec3(1000.f);
-                        } else {
-                            obj.transform->position = orig_pos;
-                        }
-                    }
-
-                    restore_removed_bbox(obj);
-                }
-            }
+        glm::vec3 displacement = obj.transform->position - start_position;
+        if (displacement != glm::vec3(0.f)) {
+            // whatever was resting on it may have lost its support:
+            wake_bodies_near(start_box);
         }
+        obj.body.settle(displacement, elapsed);
     }
+    // forget the bodies that fell asleep or left play (and repeats, from being woken twice)
+    awake_bodies.erase(std::remove_if(awake_bodies.begin(), awake_bodies.end(), [this](uint32_t h) {
+        return !store.in_room(h) || !store.object[h]->body.awake;
+    }), awake_bodies.end());
+    std::sort(awake_bodies.begin(), awake_bodies.end());
+    awake_bodies.erase(std::unique(awake_bodies.begin(), awake_bodies.end()), awake_bodies.end());
 
 }
 
@@ -1698,22 +1724,21 @@ void PlayMode::partial_update(float elapsed) {
             player.transform_middle->rotation *= glm::angleAxis(-3.0f * elapsed, up);
     }
 
-    is_side_ = true;
-    auto object_collide = collide();
-    is_side_ = false;
-    std::string object_collide_name = "";
-    if (object_collide != nullptr) {
-        object_collide_name = object_collide->name;
+    { // gather collision candidates once for this frame's sideways, slide and gravity checks
+        float t = player.air_time + elapsed;
+        float next_z = player.starting_height + 0.5f * gravity * t * t;
+        if (player.jumping) next_z += player.init_up_v * t;
+        gather_player_candidates(std::max(player.transform_middle->position.z - next_z, 0.f));
+        player_contact_cache.next_frame();
     }
 
+    uint32_t object_collide = collide(&side_debug);
+
     glm::vec3 player_motion = movement;
-    // if (object_collide_name != "") {
-    //     printf("%s\n", object_collide_name.c_str());
-    // }
-    interact_with_objects(elapsed, object_collide_name, player_motion);
+    interact_with_objects(elapsed, object_collide, player_motion);
 
     // --------- * collision with non interactable object occurred * ---------
-    if (object_collide_name != "") { // undo movement
+    if (object_collide != ObjectStore::NoObject) { // undo movement
         // SOURCE: https://wickedengine.net/2020/04/26/capsule-collision-detection/
         // Modify player velocity to slide on contact surface:
         glm::vec3 offset = ((penetration_depth + 0.0001f) * penetration_normal);
@@ -1724,7 +1749,7 @@ void PlayMode::partial_update(float elapsed) {
 
         int prev_num_collide_objs = num_collide_objs;
         auto new_collide_side = collide();
-        if (new_collide_side != nullptr || prev_num_collide_objs > 1) {
+        if (new_collide_side != ObjectStore::NoObject || prev_num_collide_objs > 1) {
             player.transform_middle->position = prev_player_position;
             player.transform_middle->rotation = prev_player_rotation;
             player.update_position(prev_player_position);
@@ -1737,11 +1762,19 @@ void PlayMode::partial_update(float elapsed) {
     prev_player_position = player.transform_middle->position;
 
     player.air_time += elapsed;
+    float next_z;
     if (player.jumping) { // jumping
-        player.transform_middle->position.z = player.starting_height + player.init_up_v * player.air_time + 0.5f * gravity * player.air_time * player.air_time;
+        next_z = player.starting_height + player.init_up_v * player.air_time + 0.5f * gravity * player.air_time * player.air_time;
     } else { // just gravity
-        player.transform_middle->position.z = player.starting_height + 0.5f * gravity * player.air_time * player.air_time;
+        next_z = player.starting_height + 0.5f * gravity * player.air_time * player.air_time;
     }
+    float current_z = player.transform_middle->position.z;
+    if (next_z < current_z) {
+        // stop the fall at the first surface below, sunk in just enough for collide() to land on it
+        float toi = sweep_player(glm::vec3(0.f, 0.f, next_z - current_z));
+        if (toi < 1.0f) next_z = current_z + toi * (next_z - current_z) - 0.001f;
+    }
+    player.transform_middle->position.z = next_z;
 
     player.tip = player.transform_middle->position;
     player.tip.z += 1.0f;
@@ -1749,12 +1782,7 @@ void PlayMode::partial_update(float elapsed) {
     player.base.z -= 1.0f;
 
     object_collide = collide();
-    object_collide_name = "";
-    if (object_collide != nullptr) {
-        object_collide_name = object_collide->name;
-    }
-
-    if (object_collide_name != "") {
+    if (object_collide != ObjectStore::NoObject) {
         bool use_up_vec = is_almost_up_vec(penetration_normal);
         // printf("use_up_vec:%d\n", use_up_vec);
         glm::vec3 new_pos;
@@ -1795,136 +1823,48 @@ void PlayMode::partial_update(float elapsed) {
         shadow.update_position(player.base, height, closest_dist);
     }
 
-    // remove all mouth related things from cat_scene
-    bool done = false;
-    while (!done) {
-        auto frame_iter = find_if(cat_scene.drawables.begin(), cat_scene.drawables.end(),
-                                [](const Scene::Drawable & elem) { return elem.transform->name.find("Mouth") != std::string::npos; });
-        if (frame_iter == cat_scene.drawables.end()) {
-            done = true;
-        } else {
-            // printf("removing %s from cat_scene and into player_held_items\n", frame_iter->transform->name.c_str());
-            player_held_items.push_back(*frame_iter);
-            cat_scene.drawables.erase(frame_iter);
-        }
-    }
-
     // animate walking
     if (prev_player_position.z == player.transform_middle->position.z) { // potentially walking
         if (player.swatting) {
-            player_swat.animate(cat_scene, true, elapsed);
+            player_swat.animate(cat_animation, elapsed);
         } else if (moved) {
-            player_walking.animate(cat_scene, true, elapsed);
+            player_walking.animate(cat_animation, elapsed);
         } else {
-            RemoveAllFrames(cat_scene);
-            AddFrame(cat_scene, player_walking.frames[player_walking.frame_idx]);
+            player_walking.show(cat_animation);
         }
     } else if (prev_player_position.z < player.transform_middle->position.z) { // up jump
-        player_up_jump.animate(cat_scene, true, elapsed);
+        player_up_jump.animate(cat_animation, elapsed);
     } else { // down jump
-        player_down_jump.animate(cat_scene, true, elapsed);
+        player_down_jump.animate(cat_animation, elapsed);
     }
 
-    // if object is being held
-    if (player.holding) {
-        // find frame being animated
-        auto cat_itr = cat_scene.drawables.begin();
-        if (cat_itr == cat_scene.drawables.end()) {
-            printf("Error no cat animation frame exists!\n");
-        } else {
-            // printf("player is holding: %s\n", player.held_obj->transform->name.c_str());
-            // printf("cat animation is: %s\n", cat_itr->transform->name.c_str());
-            // parse out every including and past . in the name
-            size_t period_pos = 0;
-            //SOURCE: https://stackoverflow.com/questions/14265581/parse-split-a-string-in-c-using-string-delimiter-standard-c
-            std::string parsed_name = player.held_obj[0].transform->name;
-            if ((period_pos = player.held_obj[0].transform->name.find(".")) != std::string::npos) {
-                parsed_name = player.held_obj[0].transform->name.substr(0, period_pos);;
-            }
-            // printf("parsed_name is: %s\n", parsed_name.c_str());
-
-            if (cat_itr->transform->name.find("Swat") == std::string::npos) { // is not a swat
-                player.mouth->position = mouth_pos[cat_itr->transform->name];
-                for (auto item = player_held_items.begin() ; item != player_held_items.end(); item++) {
-                    // printf("loop: %s\n", item->transform->name.c_str());
-                    if (item->transform->name == parsed_name + " Mouth") {
-                        // printf("display: %s\n", item->transform->name.c_str());
-                        AddFrame(cat_scene, *item);
-                        player_held_items.erase(item);
-                        break;
-                    }
-                }
-            }
-        }
+    // if object is being held, it is in the cat's mouth (except while swatting)
+    Scene::Drawable *held_item = nullptr;
+    if (player.holding && !cat_animation->mouth.empty()) {
+        player.mouth->position = cat_animation->mouth_position();
+        held_item = player.held_obj[0].held_drawable;
     }
-    // get name of animation frame if frame isn't swat
-    // set position of Mouth to the value for that frame
-    // make held item => scale 1.0, other scale 0.f
-    
+    if (held_item != shown_held_item) {
+        if (shown_held_item) shown_held_item->hidden = true;
+        if (held_item) held_item->hidden = false;
+        shown_held_item = held_item;
+    }
+
     { // camera position
         glm::vec3 camera_center = player.transform_middle->make_local_to_world() * glm::vec4(0.0f, 0.0f, 0.8f, 1.0f);
         glm::vec3 camera_direction = glm::vec3(
             cos(phi + M_PI/2) * sin(theta),
             sin(phi + M_PI/2) * sin(theta),
             cos(theta));
-        // paritally inspired by https://stackoverflow.com/questions/8812073/ray-and-square-rectangle-intersection-in-3d
-        auto rect_distance = [camera_center, camera_direction](glm::vec3 P0, glm::vec3 P1, glm::vec3 P2) {
-            glm::vec3 N = glm::cross(P1 - P0, P2 - P0);
-            float t = glm::dot(P0 - camera_center, N) / glm::dot(camera_direction, N);
-            glm::vec3 P = camera_center + t * camera_direction;
-            if (t < 0) return std::numeric_limits<float>::infinity();
-
-            float P_proj1 = glm::dot(P - P0, P1 - P0) / glm::length(P1 - P0);
-            float P_proj2 = glm::dot(P - P0, P2 - P0) / glm::length(P2 - P0);
-
-            if (0 <= P_proj1 && P_proj1 <= glm::length(P1 - P0)
-            &&  0 <= P_proj2 && P_proj2 <= glm::length(P2 - P0)) {
-                return t;
-            } else {
-                return std::numeric_limits<float>::infinity();
-            }
-        };
-        auto bbox_distance = [rect_distance](glm::vec3* bbox) {
-            float min_dist = std::numeric_limits<float>::infinity();
-            // top
-            min_dist = std::min(min_dist, rect_distance(bbox[2], bbox[1], bbox[6]));
-            // bottom
-            min_dist = std::min(min_dist, rect_distance(bbox[3], bbox[7], bbox[0]));
-            // left
-            min_dist = std::min(min_dist, rect_distance(bbox[5], bbox[4], bbox[6]));
-            // right
-            min_dist = std::min(min_dist, rect_distance(bbox[1], bbox[2], bbox[0]));
-            // front
-            min_dist = std::min(min_dist, rect_distance(bbox[2], bbox[6], bbox[3]));
-            // back
-            min_dist = std::min(min_dist, rect_distance(bbox[1], bbox[0], bbox[5]));
-            return min_dist;
-        };
         // TODO: remove this once the camera is no longer a child of the cat
         player.camera->transform->parent = nullptr;
 
+        // pull the camera in front of whatever is between it and the cat:
         float radius = camera_radius;
-        // loop  through all drawables in each scene
-        for (auto room_type : current_rooms) {
-            switch_rooms(room_type);
-            for (auto &drawable : current_scene->drawables) {
-                 if (drawable.transform->name == "Magazine Collided") continue;
-                radius = std::min(radius, 0.99f * bbox_distance(drawable.transform->bbox));
-            }
+        RayHit hit;
+        if (raycast(camera_center, camera_direction, camera_radius, RoomObject::CameraTransparent, &hit)) {
+            radius = 0.99f * hit.t;
         }
-        // for (auto &drawable : living_room_scene.drawables) {
-        //     // if (bbox_distance(drawable.transform->bbox) < radius) {
-        //     //     std::cout << drawable.transform->name << std::endl;
-        //     // }
-        //     // manually skip some items with weird bbox's
-        //     if (drawable.transform->name == "Magazine Collided"
-        //     ||  drawable.transform->name == "Mug Collided")
-        //         continue;
-        //     radius = std::min(radius, 0.99f * bbox_distance(drawable.transform->bbox));
-        // }
-        // for (auto &drawable : kitchen_scene.drawables) {
-        //     radius = std::min(radius, 0.99f * bbox_distance(drawable.transform->bbox));
-        // }
 
         glm::vec3 up = glm::vec3(0.0f, 0.0f, 1.0f);
         glm::vec3 right = glm::vec3(1.0f, 0.0f, 0.0f);
@@ -1939,38 +1879,83 @@ void PlayMode::partial_update(float elapsed) {
 void PlayMode::update(float elapsed) {
     if (game_over) return;
 
-    // printf("elapsed: %f\n", elapsed);
-    if (elapsed == 0.f || elapsed >= 0.03f) {
-        // printf("LAG time is %f\n", elapsed);
-        // exit(1);
+    // fixed-step simulation: whole FixedStep substeps are run out of the accumulated time, and draw()
+    // blends between the last two of them, so behaviour doesn't depend on the frame rate
+    step_accumulator += elapsed;
+    uint32_t substeps = 0;
+    while (step_accumulator >= FixedStep && substeps < MaxSubsteps) {
+        record_poses();
+        partial_update(FixedStep);
+        step_accumulator -= FixedStep;
+        substeps++;
+        if (game_over) return;
+
+        //reset button press counters (presses are seen by the first step after them only):
+        left.downs = 0;
+        right.downs = 0;
+        up.downs = 0;
+        down.downs = 0;
+        space.downs = 0;
+        swat.downs = 0;
+        swat.pressed = false;
     }
+    // too far behind to catch up (e.g. a hitch): drop the time rather than falling further behind
+    if (substeps == MaxSubsteps) step_accumulator = std::min(step_accumulator, FixedStep);
 
-    float partial_elapsed = std::min({elapsed, 0.03f});
-    partial_update(partial_elapsed);
-    
+    // install rooms finished loading, start loading the ones the cat is heading toward
+    stream_rooms(false);
+}
+
+void PlayMode::record_poses() {
+    interpolated_poses.clear();
+    auto record = [this](Scene::Transform *transform) {
+        InterpolatedPose pose;
+        pose.transform = transform;
+        pose.position = transform->position;
+        pose.rotation = transform->rotation;
+        interpolated_poses.emplace_back(pose);
+    };
+    record(player.transform_middle);
+    record(player.camera->transform);
+    record(shadow.drawable->transform);
+    for (uint32_t h : awake_bodies) record(store.transform[h]);
+}
 
-	//reset button press counters:
-	left.downs = 0;
-	right.downs = 0;
-	up.downs = 0;
-	down.downs = 0;
-    space.downs = 0;
-    swat.downs = 0;
-    swat.pressed = false;
+void PlayMode::blend_poses() {
+    float alpha = step_accumulator / FixedStep;
+    for (auto &pose : interpolated_poses) {
+        Scene::Transform *transform = pose.transform;
+        pose.sim_position = transform->position;
+        pose.sim_rotation = transform->rotation;
+        if (glm::length(transform->position - pose.position) > 2.0f) continue; // teleported, don't smear
+        transform->position = glm::mix(pose.position, transform->position, alpha);
+        transform->rotation = glm::slerp(pose.rotation, transform->rotation, alpha);
+    }
+}
+
+void PlayMode::unblend_poses() {
+    for (auto const &pose : interpolated_poses) {
+        pose.transform->position = pose.sim_position;
+        pose.transform->rotation = pose.sim_rotation;
+    }
 }
 
 void PlayMode::draw(glm::uvec2 const &drawable_size) {
+    blend_poses();
+
     // Draw scene meshes
     {
         //update camera aspect ratio for drawable:
         player.camera->aspect = float(drawable_size.x) / float(drawable_size.y);
 
-        //set up light type and position for lit_color_texture_program:
+        //set up light type and position for lit_color_texture_program (and its morph variant, a separate GL program):
         // TODO: consider using the Light(s) in the scene to do this
-        glUseProgram(lit_color_texture_program->program);
-        glUniform1i(lit_color_texture_program->LIGHT_TYPE_int, 1);
-        glUniform3fv(lit_color_texture_program->LIGHT_DIRECTION_vec3, 1, glm::value_ptr(glm::vec3(0.0f, 0.0f,-1.0f)));
-        glUniform3fv(lit_color_texture_program->LIGHT_ENERGY_vec3, 1, glm::value_ptr(glm::vec3(1.0f, 1.0f, 0.95f)));
+        for (LitColorTextureProgram const *program : {&*lit_color_texture_program, &*lit_color_texture_morph_program}) {
+            glUseProgram(program->program);
+            glUniform1i(program->LIGHT_TYPE_int, 1);
+            glUniform3fv(program->LIGHT_DIRECTION_vec3, 1, glm::value_ptr(glm::vec3(0.0f, 0.0f,-1.0f)));
+            glUniform3fv(program->LIGHT_ENERGY_vec3, 1, glm::value_ptr(glm::vec3(1.0f, 1.0f, 0.95f)));
+        }
         glUseProgram(0);
 
         glUseProgram(blob_shadow_texture_program->program);
@@ -1996,16 +1981,16 @@ void PlayMode::draw(glm::uvec2 const &drawable_size) {
         // living_room_scene.draw(*player.camera);
         // kitchen_scene.draw(*player.camera);
 
-        // ! TODO change order here
-        // Maybe cat second to last?
-        cat_scene.draw(*player.camera);
-        // case on what's in current_rooms
-        for (auto room_type : all_rooms) {
-            switch_rooms(room_type);
-            current_scene->draw(*player.camera);
-        }
-
-        shadow_scene.draw(*player.camera);
+        // one sorted batch for everything, so GL state only changes between programs/meshes; the blob shadow is
+        // blended, so it goes in a later pass
+        cat_scene.update_transforms();
+        world_scene.update_transforms();
+        shadow_scene.update_transforms();
+        render_queue.clear();
+        render_queue.add(cat_scene, *player.camera);
+        render_queue.add(world_scene, *player.camera, AllRooms);
+        render_queue.add(shadow_scene, *player.camera, ~0u, 1, true);
+        render_queue.draw();
     }
 
     // Draw text
@@ -2022,7 +2007,7 @@ void PlayMode::draw(glm::uvec2 const &drawable_size) {
     }
 
     // Draw text
-        // draw_lines.draw(center_, tri_point_, glm::u8vec4(0xff, 0x00, 0x00, 0xff));
+        // draw_lines.draw(side_debug.segment_point, side_debug.surface_point, glm::u8vec4(0xff, 0x00, 0x00, 0xff));
         // float r = player.radius;
 
         // glm::vec3 capsule0_tip = player.transform_front->make_local_to_world() * glm::vec4(player.transform_front->position, 1.0f);
@@ -2100,4 +2085,6 @@ void PlayMode::draw(glm::uvec2 const &drawable_size) {
         //     draw_lines.draw(drawable.transform->bbox[4], drawable.transform->bbox[5], glm::u8vec4(0x00, 0xff, 0x00, 0xff));
 
         // }
+
+    unblend_poses();
 }
@@ -1,10 +1,16 @@
 #include "Mode.hpp"
 
 #include "Scene.hpp"
+#include "RenderQueue.hpp"
 #include "Load.hpp"
 #include "Sound.hpp"
 #include "RoomObject.hpp"
+#include "ObjectStore.hpp"
+#include "RoomGraph.hpp"
+#include "RoomStreamer.hpp"
 #include "Collision.hpp"
+#include "AABBTree.hpp"
+#include "GroundGrid.hpp"
 #include "Mesh.hpp"
 #include "Load.hpp"
 #include "GameText.hpp"
@@ -12,6 +18,7 @@
 #include <glm/glm.hpp>
 
 #include <vector>
+#include <list>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -29,8 +36,12 @@ struct PlayMode : Mode {
 		Bathroom,
         Office,
         Bedroom,
-        WallsDoorsFloorsStairs
+        WallsDoorsFloorsStairs,
+        RoomCount
 	};
+    // rooms are partitions of one world; sets of them are bitmasks of room_bit
+    static uint32_t room_bit(RoomType room) { return 1u << room; }
+    static constexpr uint32_t AllRooms = (1u << RoomCount) - 1;
 
 	//functions called by main loop:
 	virtual bool handle_event(SDL_Event const &, glm::uvec2 const &window_size) override;
@@ -38,11 +49,15 @@ struct PlayMode : Mode {
     virtual void update(float elapsed) override;
 	virtual void draw(glm::uvec2 const &drawable_size) override;
 
-    void GenerateBBox(Scene &scene, Load<MeshBuffer> &meshes);
+    void GenerateBBox(Scene &scene, MeshBuffer const &meshes);
 	void updateBBox(Scene::Transform *transform, glm::vec3 displacement);
 
-    bool player_front_inside_bbox(Scene::Transform *transform);
+    void build_room_graph();
     void populate_current_rooms();
+    void stream_rooms(bool wait);
+    void install_room(RoomType room);
+    void evict_room(RoomType room);
+    bool can_evict(RoomType room) const;
 
     void generate_wdfs_objects(Scene &scene, std::vector<RoomObject> &objects);
 	void generate_living_room_objects(Scene &scene, std::vector<RoomObject> &objects);
@@ -51,15 +66,39 @@ struct PlayMode : Mode {
     void generate_bathroom_objects(Scene &scene, std::vector<RoomObject> &objects);
     void generate_office_objects(Scene &scene, std::vector<RoomObject> &objects);
     void generate_room_objects(Scene &scene, std::vector<RoomObject> &objects, RoomType room_type);
-	void switch_rooms(RoomType room_type);
+    void build_colliders(Scene &scene, MeshBuffer const &meshes, std::vector<RoomObject> &objects);
+    void add_room(Scene &scene, std::vector<RoomObject> &objects, RoomType room);
+    void build_world_tree();
+    void insert_world_object(RoomObject const &obj, RoomType room);
+    void erase_world_object(std::vector<RoomObject>::iterator obj);
+    void relink_world_objects();
 	float get_surface_below_height(float &closest_dist);
 	// void check_room();
 	// std::string floor_collide(); //RoomType floor_collide();
 
-    Scene::Transform *collide();
-    std::string paw_collide();
-	std::string capsule_collide(RoomObject &current_obj, glm::vec3 *pen_normal, float *pen_depth);
-    void interact_with_objects(float elapsed, std::string object_collide_name, glm::vec3 player_motion);
+    // the object the cat's capsules are pushed out of hardest (ObjectStore::NoObject if none)
+    uint32_t collide(CollisionDebug *debug = nullptr);
+    void player_capsules(CapsuleCollider capsules[2]);
+    void gather_player_candidates(float fall);
+    void collide_player(std::vector<Contact> *contacts, CollisionDebug *debug = nullptr);
+    float sweep_player(glm::vec3 motion);
+    void gather_awake_bodies();
+    void wake_body(uint32_t handle);
+    void wake_bodies_near(AABB const &box);
+    uint32_t paw_collide();
+	// these skip objects without a RoomObject::Category bit in current_obj.mask
+	uint32_t capsule_collide(RoomObject &current_obj, glm::vec3 *pen_normal, float *pen_depth);
+	uint32_t capsule_sweep(RoomObject &current_obj, glm::vec3 motion, float *toi);
+
+    // nearest object bbox along origin + t * dir, t in [0, max_t], over the current rooms (dir needn't be
+    // unit length; t is in units of it). Objects with any of the 'skip' RoomObject::Flags are ignored.
+    // 'object' is the hit's ObjectStore handle.
+    struct RayHit {
+        float t = 0.f;
+        uint32_t object = -1U;
+    };
+    bool raycast(glm::vec3 origin, glm::vec3 dir, float max_t, uint32_t skip, RayHit *hit);
+    void interact_with_objects(float elapsed, uint32_t object_collide, glm::vec3 player_motion);
 
 	// When the game is first loaded, it's after showng the instruction screen
 	// But the instruction screen can be brought back up
@@ -74,48 +113,41 @@ struct PlayMode : Mode {
 	} left, right, down, up, space, swat;
 
 	// ------------------ Rooms ------------------
-	// RoomType current_room = RoomType::LivingRoom;
-	Scene *current_scene = nullptr;
-	std::vector<RoomObject> *current_objects = nullptr;
-
 	//local copy of the game scene (so code can change it during gameplay):
 	Scene shadow_scene;
 	Scene cat_scene;
-	
-    Scene living_room_scene;
-    Scene kitchen_scene;
-    Scene wdfs_scene;
-    Scene bedroom_scene;
-    Scene bathroom_scene;
-    Scene office_scene;
 
-    Scene bounds_scene; // SPECIAL
+    // every room's drawables, tagged with their room (Drawable::partition)
+    Scene world_scene;
 
-	std::vector<RoomObject> living_room_objects;
-	std::vector<RoomObject> kitchen_objects;
-    std::vector<RoomObject> wdfs_objects;
-    std::vector<RoomObject> bedroom_objects;
-    std::vector<RoomObject> bathroom_objects;
-    std::vector<RoomObject> office_objects;
-
-    // hardcode all rooms in for now
-    std::vector<RoomType> current_rooms = {
-        WallsDoorsFloorsStairs, 
-        Kitchen, 
-        Bedroom, 
-        Bathroom,
-        Office,
-		LivingRoom		// hardcoded last so cat shadow can render last!
-    };
+    Scene bounds_scene; // SPECIAL
 
-    std::vector<RoomType> all_rooms = {
-        WallsDoorsFloorsStairs, 
-        Kitchen, 
-        Bedroom, 
-        Bathroom,
-        Office,
-		LivingRoom		// hardcoded last so cat shadow can render last!
-    };
+    RenderQueue render_queue; // what draw() submits, reused each frame
+
+    // every room's objects, grouped by room: room r has world_objects[room_begin[r], room_begin[r+1])
+    std::vector<RoomObject> world_objects;
+    uint32_t room_begin[RoomCount + 1] = {};
+    ObjectStore store; // collision state of every object, by RoomObject::id
+
+    // broadphase over all objects (leaf user value = ObjectStore handle); queries skip rooms not in current_rooms
+    AABBTree world_tree;
+    // standable surfaces of all objects, for height-below queries (kept in sync with the tree)
+    GroundGrid world_ground;
+
+    // room bounds and how they connect, for finding the rooms the cat is in
+    RoomGraph room_graph;
+    // rooms the cat is in (and always the stairs), see populate_current_rooms
+    uint32_t current_rooms = AllRooms;
+    RoomType cat_room = LivingRoom; // the first of them that isn't the stairs, where things are put down
+
+    // the rooms' meshes and scenes, read in the background as the cat comes within load_radius links of them in
+    // room_graph and freed again past evict_radius (the stairs are always loaded); see stream_rooms
+    RoomStreamer room_streamer;
+    uint32_t load_radius = 1;
+    uint32_t evict_radius = 2;
+    // an evicted room's drawables, out of world_scene, and the objects it had in the tree, until it is back
+    std::vector<Scene::Drawable> parked_drawables[RoomCount];
+    std::vector<uint32_t> parked_objects[RoomCount];
 
 	// save floors of all rooms specially for collisions to avoid lookups
 	Scene::Transform *living_room_floor = nullptr;
@@ -186,6 +218,20 @@ struct PlayMode : Mode {
 
     glm::vec3 penetration_normal;
     float penetration_depth;
+    CollisionDebug side_debug; // contact from the last sideways collide(), for debug drawing
+
+    // broadphase results for the cat, reused by every collide() in a frame (see gather_player_candidates)
+    static constexpr uint32_t PlayerMask = RoomObject::Solid;  // what the cat's body bumps into
+    static constexpr uint32_t PawMask = RoomObject::Swattable; // and what its paw can hit
+    std::vector<uint32_t> player_candidates; // ObjectStore handles
+    AABB player_candidate_box;
+    bool player_candidates_stale = true; // an object was added to a room since they were gathered
+    std::vector<Contact> player_contacts; // from the last collide(), deepest first
+    ContactCache player_contact_cache; // last face hit per (cat capsule, object), usually the one being stood on
+
+    // RoomObject bodies (see RoomObject::has_body) in the current rooms that still need stepping
+    std::vector<uint32_t> awake_bodies; // ObjectStore handles
+    uint32_t awake_bodies_rooms = 0; // current_rooms when awake_bodies was gathered
 
     int num_collide_objs = 0;
     // bool collide_front = false;
@@ -210,23 +256,56 @@ struct PlayMode : Mode {
         {"DownJump5", glm::vec3(-1.5273f, 0.f, -0.10533f)}
     };
 
+    // Keyframes are drawables that stay in cat_scene; all but the playing animation's current one are hidden,
+    // so switching frames is flipping two flags. Between switches the shown frame blends toward the next one on
+    // the GPU (see MorphFrames), 'weight' of the way there.
     struct Animation {
-        std::vector<Scene::Drawable> frames;
+        std::vector<Scene::Drawable *> frames;
+        std::vector<bool> morphs;     // does frame i blend toward frame i+1?
+        std::vector<glm::vec3> mouth; // where the Mouth transform goes in each frame; empty if nothing is held (swat)
         std::vector<float> frame_times;
         uint32_t frame_idx = 0;
         float timer = 0.f;
+        float weight = 0.f;
         std::string name;
 
-        void animate(Scene &scene, bool enable, float elapsed);
+        // steps this animation; if another one was 'playing', switches to this one from its first frame
+        void animate(Animation *&playing, float elapsed);
+        // the Mouth position, blended like the frame
+        glm::vec3 mouth_position() const;
+        // shows frame_idx as it is (no stepping) and makes this the 'playing' one
+        void show(Animation *&playing);
     } player_walking, player_up_jump, player_down_jump, player_swat;
+    Animation *cat_animation = nullptr; // the one being shown
 
-    std::vector<Scene::Drawable> player_held_items;
+    // the "<label> Mouth" drawables in cat_scene (hidden unless carried), by RoomObject::label; looked up once on
+    // pickup into RoomObject::held_drawable
+    std::unordered_map<std::string, Scene::Drawable *> player_held_items;
+    Scene::Drawable *shown_held_item = nullptr;
 
 	int score = 0;
 	float theta = -0.3f * (float)M_PI;
 	float phi = ((float)M_PI)/2.f;
 	float camera_radius = 10.0f;
 
+    // ----- Fixed-step simulation (see update) -----
+    static constexpr float FixedStep = 1.0f / 120.0f;
+    static constexpr uint32_t MaxSubsteps = 12; // 0.1s of simulation per frame at most
+    float step_accumulator = 0.0f;
+    // transforms the simulation moves, with their pose from before the last substep; draw() shows them
+    // step_accumulator / FixedStep of the way from there to the current pose
+    struct InterpolatedPose {
+        Scene::Transform *transform = nullptr;
+        glm::vec3 position;
+        glm::quat rotation;
+        glm::vec3 sim_position; // the real pose, put back after drawing
+        glm::quat sim_rotation;
+    };
+    std::vector<InterpolatedPose> interpolated_poses;
+    void record_poses();
+    void blend_poses();
+    void unblend_poses();
+
 	struct GameTimer {
 		float seconds = 5.0f * 60.f;		// TODO change back to 8min
 		std::string to_string() {
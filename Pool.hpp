@@ -0,0 +1,250 @@
+#pragma once
+
+/*
+ * A Pool< T > stores elements in fixed-size chunks of slots, for Scene's transforms,
+ *  drawables, cameras, and lights.
+ *
+ * - Elements never move: pointers to them stay good until they are erased,
+ *   even across splice() into another pool.
+ * - Iteration walks the chunks in slot order, skipping empty slots.
+ * - Slots freed by erase() are reused by later emplace_back() calls, so
+ *   iteration order is insertion order only until something is erased.
+ * - A Handle (slot index + generation) names an element without a pointer;
+ *   get() returns nullptr once that element has been erased.
+ *
+ * It is used much like the std::list it replaced, except that emplace_back
+ *  returns the new element (there is no back()).
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+template< typename T, uint32_t ChunkSize = 64 >
+struct Pool {
+	struct Handle {
+		uint32_t index = -1U;
+		uint32_t generation = 0;
+	};
+
+	Pool() = default;
+	Pool(Pool const &other) { *this = other; }
+	Pool(Pool &&other) { *this = std::move(other); }
+	Pool &operator=(Pool const &other);
+	Pool &operator=(Pool &&other);
+	~Pool() { clear(); }
+
+	//-- iteration ---
+	template< typename P, typename V >
+	struct Iterator {
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = V *;
+		using reference = V &;
+
+		P *pool = nullptr;
+		uint32_t index = 0;
+
+		Iterator() = default;
+		Iterator(P *pool_, uint32_t index_) : pool(pool_), index(index_) { }
+		operator Iterator< Pool const, T const >() const { return Iterator< Pool const, T const >(pool, index); }
+
+		V &operator*() const { return *pool->element(index); }
+		V *operator->() const { return pool->element(index); }
+		Iterator &operator++() { index = pool->next_alive(index + 1); return *this; }
+		Iterator operator++(int) { Iterator ret = *this; ++(*this); return ret; }
+		bool operator==(Iterator const &o) const { return index == o.index; }
+		bool operator!=(Iterator const &o) const { return index != o.index; }
+	};
+	using iterator = Iterator< Pool, T >;
+	using const_iterator = Iterator< Pool const, T const >;
+
+	iterator begin() { return iterator(this, next_alive(0)); }
+	iterator end() { return iterator(this, used); }
+	const_iterator begin() const { return const_iterator(this, next_alive(0)); }
+	const_iterator end() const { return const_iterator(this, used); }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	T &front() { assert(count); return *begin(); }
+	T const &front() const { assert(count); return *begin(); }
+
+	//-- adding and removing ---
+	template< typename... Args >
+	T &emplace_back(Args &&... args);
+	T &push_back(T const &value) { return emplace_back(value); }
+	T &push_back(T &&value) { return emplace_back(std::move(value)); }
+
+	//returns the element after the erased one:
+	iterator erase(const_iterator at);
+	void clear();
+
+	//move all of other's elements into this pool without moving them in memory
+	// (pointers to them stay good; handles from 'other' don't). Leaves 'other' empty.
+	void splice(Pool &other);
+
+	//-- handles ---
+	Handle handle_of(T const *element) const { Slot const &s = slot_of(element); return Handle{s.index, s.generation}; }
+	uint32_t index_of(T const *element) const { return slot_of(element).index; }
+	T *get(Handle handle) {
+		if (handle.index >= used) return nullptr;
+		Slot &s = slot(handle.index);
+		return (s.alive && s.generation == handle.generation) ? s.get() : nullptr;
+	}
+	//one past the largest slot index in use (for index-keyed side tables):
+	uint32_t slot_count() const { return used; }
+
+	//-- internals ---
+	struct Slot {
+		alignas(T) unsigned char storage[sizeof(T)];
+		uint32_t index = 0;
+		uint32_t generation = 0;
+		bool alive = false;
+		T *get() { return reinterpret_cast< T * >(storage); }
+		T const *get() const { return reinterpret_cast< T const * >(storage); }
+	};
+	struct Chunk {
+		Slot slots[ChunkSize];
+	};
+	std::vector< std::unique_ptr< Chunk > > chunks;
+	std::vector< uint32_t > free; //slots below 'used' that are empty, reused last-freed first
+	uint32_t used = 0; //slots at or past this index have never held anything
+	uint32_t count = 0;
+
+	Slot &slot(uint32_t index) { return chunks[index / ChunkSize]->slots[index % ChunkSize]; }
+	Slot const &slot(uint32_t index) const { return chunks[index / ChunkSize]->slots[index % ChunkSize]; }
+	Slot const &slot_of(T const *element) const {
+		return *reinterpret_cast< Slot const * >(reinterpret_cast< unsigned char const * >(element) - offsetof(Slot, storage));
+	}
+	T *element(uint32_t index) { return slot(index).get(); }
+	T const *element(uint32_t index) const { return slot(index).get(); }
+	uint32_t next_alive(uint32_t index) const {
+		while (index < used && !slot(index).alive) ++index;
+		return index;
+	}
+	uint32_t take_slot();
+};
+
+template< typename T, uint32_t ChunkSize >
+uint32_t Pool< T, ChunkSize >::take_slot() {
+	if (!free.empty()) {
+		uint32_t index = free.back();
+		free.pop_back();
+		return index;
+	}
+	if (used == chunks.size() * ChunkSize) {
+		chunks.emplace_back(new Chunk);
+		for (uint32_t i = 0; i < ChunkSize; ++i) chunks.back()->slots[i].index = used + i;
+	}
+	return used++;
+}
+
+template< typename T, uint32_t ChunkSize >
+template< typename... Args >
+T &Pool< T, ChunkSize >::emplace_back(Args &&... args) {
+	uint32_t index = take_slot();
+	Slot &s = slot(index);
+	try {
+		new (s.storage) T(std::forward< Args >(args)...);
+	} catch (...) {
+		free.emplace_back(index);
+		throw;
+	}
+	s.alive = true;
+	count += 1;
+	return *s.get();
+}
+
+template< typename T, uint32_t ChunkSize >
+typename Pool< T, ChunkSize >::iterator Pool< T, ChunkSize >::erase(const_iterator at) {
+	assert(at.pool == this && at.index < used);
+	Slot &s = slot(at.index);
+	assert(s.alive);
+	s.get()->~T();
+	s.alive = false;
+	s.generation += 1;
+	count -= 1;
+	free.emplace_back(at.index);
+	return iterator(this, next_alive(at.index + 1));
+}
+
+template< typename T, uint32_t ChunkSize >
+void Pool< T, ChunkSize >::clear() {
+	for (uint32_t i = 0; i < used; ++i) {
+		Slot &s = slot(i);
+		if (!s.alive) continue;
+		s.get()->~T();
+		s.alive = false;
+		s.generation += 1;
+	}
+	free.clear();
+	used = 0;
+	count = 0;
+}
+
+template< typename T, uint32_t ChunkSize >
+Pool< T, ChunkSize > &Pool< T, ChunkSize >::operator=(Pool const &other) {
+	if (this == &other) return *this;
+	clear();
+	//same slot layout as 'other', so an element's index is the same in both:
+	while (chunks.size() * ChunkSize < other.used) {
+		uint32_t base = uint32_t(chunks.size()) * ChunkSize;
+		chunks.emplace_back(new Chunk);
+		for (uint32_t i = 0; i < ChunkSize; ++i) chunks.back()->slots[i].index = base + i;
+	}
+	for (uint32_t i = 0; i < other.used; ++i) {
+		Slot const &o = other.slot(i);
+		if (!o.alive) continue;
+		Slot &s = slot(i);
+		new (s.storage) T(*o.get());
+		s.alive = true;
+	}
+	free = other.free;
+	used = other.used;
+	count = other.count;
+	return *this;
+}
+
+template< typename T, uint32_t ChunkSize >
+Pool< T, ChunkSize > &Pool< T, ChunkSize >::operator=(Pool &&other) {
+	if (this == &other) return *this;
+	clear();
+	chunks = std::move(other.chunks);
+	free = std::move(other.free);
+	used = other.used;
+	count = other.count;
+	other.chunks.clear();
+	other.free.clear();
+	other.used = 0;
+	other.count = 0;
+	return *this;
+}
+
+template< typename T, uint32_t ChunkSize >
+void Pool< T, ChunkSize >::splice(Pool &other) {
+	if (this == &other || other.chunks.empty()) return;
+
+	//the never-used tail of this pool's last chunk becomes free space:
+	uint32_t base = uint32_t(chunks.size()) * ChunkSize;
+	for (uint32_t i = used; i < base; ++i) free.emplace_back(i);
+
+	//the chunks themselves change owner, so the elements stay put:
+	for (auto &chunk : other.chunks) {
+		for (uint32_t i = 0; i < ChunkSize; ++i) chunk->slots[i].index += base;
+		chunks.emplace_back(std::move(chunk));
+	}
+	for (uint32_t index : other.free) free.emplace_back(base + index);
+	used = base + other.used;
+	count += other.count;
+
+	other.chunks.clear();
+	other.free.clear();
+	other.used = 0;
+	other.count = 0;
+}
@@ -0,0 +1,148 @@
+#include "RenderQueue.hpp"
+
+#include "gl_errors.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+void RenderQueue::clear() {
+	views.clear();
+	items.clear();
+	culled = 0;
+}
+
+void RenderQueue::add(Scene const &scene, Scene::Camera const &camera, uint32_t partitions, uint8_t pass, bool blended) {
+	assert(camera.transform);
+	glm::mat4 world_to_clip = camera.make_projection() * glm::mat4(camera.transform->make_world_to_local());
+	add(scene, world_to_clip, glm::mat4x3(1.0f), partitions, pass, blended);
+}
+
+void RenderQueue::add(Scene const &scene, glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_light,
+	uint32_t partitions, uint8_t pass, bool blended) {
+
+	uint32_t view = uint32_t(views.size());
+	views.emplace_back(View{world_to_clip, world_to_light});
+	Scene::Frustum frustum(world_to_clip);
+
+	for (auto const &drawable : scene.drawables) {
+		if (!(partitions & (1u << drawable.partition))) continue;
+		if (drawable.hidden) continue;
+
+		Scene::Drawable::Pipeline const &pipeline = drawable.pipeline;
+		//skip drawables that couldn't draw anything (see Scene::draw):
+		if (pipeline.program == 0 || pipeline.vao == 0 || pipeline.count == 0) continue;
+		//skip drawables that are out of view:
+		if (!frustum.overlaps(drawable)) {
+			culled += 1;
+			continue;
+		}
+
+		//view distance of the drawable's origin (w of its clip position), as float bits, which order like the floats
+		// do for non-negative values:
+		glm::vec3 origin = drawable.transform->make_local_to_world()[3];
+		float w = std::max(0.0f, (world_to_clip * glm::vec4(origin, 1.0f)).w);
+		uint32_t depth_bits;
+		static_assert(sizeof(depth_bits) == sizeof(w), "float is 32 bits.");
+		std::memcpy(&depth_bits, &w, sizeof(w));
+
+		uint64_t key = 0;
+		key |= uint64_t(pass & 0xf) << 60;
+		if (!blended) {
+			key |= uint64_t(pipeline.program & 0xfff) << 48;
+			key |= uint64_t(pipeline.vao & 0xffff) << 32;
+			key |= uint64_t(pipeline.textures[0].texture & 0xffff) << 16;
+			key |= uint64_t(depth_bits >> 16);
+		} else {
+			//back to front, so each is blended over what is behind it; state only groups drawables at the same depth:
+			key |= uint64_t(~depth_bits) << 28;
+			key |= uint64_t(pipeline.program & 0xfff) << 16;
+			key |= uint64_t(pipeline.vao & 0xffff);
+		}
+
+		items.emplace_back(Item{key, &drawable, view});
+	}
+}
+
+void RenderQueue::draw() {
+	//stable, so equal keys keep the order they were added in:
+	std::stable_sort(items.begin(), items.end(), [](Item const &a, Item const &b) { return a.key < b.key; });
+
+	stats = Stats();
+	stats.culled = culled;
+
+	GLuint program = 0;
+	GLuint vao = 0;
+	Scene::Drawable::Pipeline::TextureInfo bound[Scene::Drawable::Pipeline::TextureCount];
+	GLuint active = 0; //texture unit
+	glActiveTexture(GL_TEXTURE0);
+
+	auto bind_texture = [&](GLuint unit, GLenum target, GLuint texture) {
+		if (active != unit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			active = unit;
+		}
+		glBindTexture(target, texture);
+		stats.textures += 1;
+	};
+
+	for (auto const &item : items) {
+		Scene::Drawable const &drawable = *item.drawable;
+		Scene::Drawable::Pipeline const &pipeline = drawable.pipeline;
+		View const &view = views[item.view];
+
+		if (pipeline.program != program) {
+			glUseProgram(pipeline.program);
+			program = pipeline.program;
+			stats.programs += 1;
+		}
+		if (pipeline.vao != vao) {
+			glBindVertexArray(pipeline.vao);
+			vao = pipeline.vao;
+			stats.vaos += 1;
+		}
+
+		//the same uniforms as Scene::draw:
+		glm::mat4x3 object_to_world = drawable.transform->make_local_to_world();
+		if (pipeline.OBJECT_TO_CLIP_mat4 != -1U) {
+			glm::mat4 object_to_clip = view.world_to_clip * glm::mat4(object_to_world);
+			glUniformMatrix4fv(pipeline.OBJECT_TO_CLIP_mat4, 1, GL_FALSE, glm::value_ptr(object_to_clip));
+		}
+		glm::mat4x3 object_to_light = view.world_to_light * glm::mat4(object_to_world);
+		if (pipeline.OBJECT_TO_LIGHT_mat4x3 != -1U) {
+			glUniformMatrix4x3fv(pipeline.OBJECT_TO_LIGHT_mat4x3, 1, GL_FALSE, glm::value_ptr(object_to_light));
+		}
+		if (pipeline.NORMAL_TO_LIGHT_mat3 != -1U) {
+			glm::mat3 normal_to_light = glm::inverse(glm::transpose(glm::mat3(object_to_light)));
+			glUniformMatrix3fv(pipeline.NORMAL_TO_LIGHT_mat3, 1, GL_FALSE, glm::value_ptr(normal_to_light));
+		}
+		if (pipeline.set_uniforms) pipeline.set_uniforms();
+
+		//textures: units the pipeline doesn't use are left empty, as Scene::draw leaves them
+		for (GLuint i = 0; i < Scene::Drawable::Pipeline::TextureCount; ++i) {
+			auto const &want = pipeline.textures[i];
+			auto &have = bound[i];
+			if (want.texture == have.texture && (want.texture == 0 || want.target == have.target)) continue;
+			if (have.texture != 0 && (want.texture == 0 || want.target != have.target)) {
+				bind_texture(i, have.target, 0);
+			}
+			if (want.texture != 0) bind_texture(i, want.target, want.texture);
+			have.texture = want.texture;
+			have.target = want.target;
+		}
+
+		glDrawArrays(pipeline.type, pipeline.start, pipeline.count);
+		stats.draws += 1;
+	}
+
+	//leave the state the way Scene::draw does:
+	for (GLuint i = 0; i < Scene::Drawable::Pipeline::TextureCount; ++i) {
+		if (bound[i].texture != 0) bind_texture(i, bound[i].target, 0);
+	}
+	glActiveTexture(GL_TEXTURE0);
+	glUseProgram(0);
+	glBindVertexArray(0);
+
+	GL_ERRORS();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+ * A RenderQueue collects the drawables of any number of scenes for one frame,
+ *  sorts them so that drawables sharing GL state end up next to each other,
+ *  and draws them changing only the state that differs from the previous one.
+ *
+ * Items are ordered by a 64-bit key, most significant field first:
+ *   pass     4 bits -- passes are drawn in order (e.g. blended things after opaque ones)
+ *   program 12 bits
+ *   vao     16 bits
+ *   texture 16 bits -- the one bound to unit 0
+ *   depth   16 bits -- nearest first (top bits of the view distance)
+ * ..except for drawables added as blended, which alpha blending needs drawn back to front:
+ *   pass     4 bits
+ *   depth   32 bits -- farthest first
+ *   program 12 bits
+ *   vao     16 bits
+ * GL names are folded into their fields, so two names rarely share a group; the
+ *  state actually set is always compared in full.
+ *
+ * Usage, each frame:
+ *   queue.clear();
+ *   queue.add(scene_a, camera);
+ *   queue.add(scene_b, camera, partitions, 1, true); //after everything in pass 0, back to front
+ *   queue.draw();
+ */
+
+#include "Scene.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct RenderQueue {
+	//drop last frame's items (keeps the storage):
+	void clear();
+
+	//queue scene's drawables that aren't hidden, have their bit (1 << partition) set in 'partitions', and whose
+	// bounds are in view of world_to_clip (see Scene::Frustum):
+	// ('blended' drawables are sorted back to front, as alpha blending needs; give them a pass of their own,
+	//  after the opaque ones)
+	void add(Scene const &scene, Scene::Camera const &camera, uint32_t partitions = ~0u, uint8_t pass = 0, bool blended = false);
+	void add(Scene const &scene, glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_light = glm::mat4x3(1.0f),
+		uint32_t partitions = ~0u, uint8_t pass = 0, bool blended = false);
+
+	//sort and draw everything queued:
+	void draw();
+
+	//what the last draw() did:
+	struct Stats {
+		uint32_t draws = 0;
+		uint32_t programs = 0; //glUseProgram calls
+		uint32_t vaos = 0; //glBindVertexArray calls
+		uint32_t textures = 0; //glBindTexture calls
+		uint32_t culled = 0; //drawables add() skipped as out of view
+	} stats;
+
+	//-- internals ---
+	struct View {
+		glm::mat4 world_to_clip;
+		glm::mat4x3 world_to_light;
+	};
+	struct Item {
+		uint64_t key;
+		Scene::Drawable const *drawable;
+		uint32_t view; //index into views
+	};
+	std::vector< View > views;
+	std::vector< Item > items;
+	uint32_t culled = 0; //since clear()
+};
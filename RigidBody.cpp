@@ -0,0 +1,28 @@
+#include "RigidBody.hpp"
+
+glm::vec3 RigidBody::integrate(float elapsed) {
+    glm::vec3 displacement = velocity * elapsed;
+
+    float speed = glm::length(velocity);
+    float slowed = speed - friction * elapsed;
+    if (slowed < RestSpeed) velocity = glm::vec3(0.f);
+    else velocity *= slowed / speed;
+    return displacement;
+}
+
+void RigidBody::bounce(glm::vec3 normal) {
+    glm::vec2 away = glm::vec2(normal);
+    if (glm::length(away) < 0.5f * glm::length(normal)) return; // support, not a wall
+    velocity = glm::vec3(glm::normalize(away) * glm::length(velocity), 0.f);
+}
+
+bool RigidBody::settle(glm::vec3 displacement, float elapsed) {
+    if (glm::length(displacement) > 1e-3f || velocity != glm::vec3(0.f)) {
+        still_time = 0.f;
+        return false;
+    }
+    still_time += elapsed;
+    if (still_time < SleepDelay) return false;
+    sleep();
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Motion state of a prop the cat can knock around (PushOff and Steal objects).
+//
+// A body slides with a horizontal velocity that friction wears down, and falls at a fixed speed until
+// something holds it up (PlayMode steps awake bodies and does the sweeps). Once it has stayed put for
+// SleepDelay seconds it goes to sleep and is skipped entirely until something wakes it: the cat pushing
+// or dropping it, or whatever it rests on moving away or disappearing.
+
+#include <glm/glm.hpp>
+
+struct RigidBody {
+    glm::vec3 velocity = glm::vec3(0.f); // horizontal (z is unused, falling is fall_speed)
+    float friction = 5.0f;               // horizontal deceleration, units/s^2
+    float fall_speed = 6.0f;             // while nothing is below
+
+    static constexpr float RestSpeed = 0.01f;  // slower than this counts as stopped
+    static constexpr float SleepDelay = 0.25f; // seconds without moving before sleeping
+
+    bool awake = true; // start awake so everything settles once
+    float still_time = 0.f;
+
+    void wake() { awake = true; still_time = 0.f; }
+    void sleep() { awake = false; still_time = 0.f; velocity = glm::vec3(0.f); }
+
+    // horizontal displacement for a step of 'elapsed', after which friction is applied
+    glm::vec3 integrate(float elapsed);
+    // contact response against a surface with normal 'normal': keeps the speed but slides away from it;
+    // surfaces facing mostly up or down (the body's support) don't deflect it
+    void bounce(glm::vec3 normal);
+    // call after each step with how far the body moved; returns true if it fell asleep
+    bool settle(glm::vec3 displacement, float elapsed);
+};
@@ -0,0 +1,133 @@
+#include "RoomGraph.hpp"
+
+#include <algorithm>
+
+static bool box_contains(AABB const &box, glm::vec3 p) {
+    return box.min.x <= p.x && p.x <= box.max.x
+        && box.min.y <= p.y && p.y <= box.max.y
+        && box.min.z <= p.z && p.z <= box.max.z;
+}
+
+void RoomGraph::add_room(uint32_t id, AABB const &bounds) {
+    Room room;
+    room.id = id;
+    room.bounds = bounds;
+    rooms.emplace_back(room);
+}
+
+void RoomGraph::add_portal(AABB const &portal) {
+    portals.emplace_back(portal);
+}
+
+void RoomGraph::build(float slack) {
+    auto link = [this](uint32_t a, uint32_t b) {
+        auto &n = rooms[a].neighbors;
+        if (std::find(n.begin(), n.end(), b) == n.end()) n.emplace_back(b);
+    };
+    for (uint32_t a = 0; a < rooms.size(); a++) {
+        for (uint32_t b = a + 1; b < rooms.size(); b++) {
+            AABB const &ba = rooms[a].bounds, &bb = rooms[b].bounds;
+            if (!ba.overlaps(bb)) continue;
+            link(a, b);
+            link(b, a);
+            AABB shared(glm::max(ba.min, bb.min), glm::min(ba.max, bb.max));
+            rooms[a].shared.emplace_back(shared);
+            rooms[b].shared.emplace_back(shared);
+        }
+    }
+    for (auto const &portal : portals) {
+        AABB reach = portal.expanded(slack);
+        std::vector< uint32_t > sides;
+        for (uint32_t r = 0; r < rooms.size(); r++) {
+            if (rooms[r].bounds.overlaps(reach)) sides.emplace_back(r);
+        }
+        for (uint32_t a : sides) {
+            for (uint32_t b : sides) {
+                if (a != b) link(a, b);
+            }
+        }
+    }
+}
+
+bool RoomGraph::room_contains(uint32_t room, glm::vec3 p) const {
+    return box_contains(rooms[room].bounds, p);
+}
+
+bool RoomGraph::near_boundary(uint32_t room, glm::vec3 p, float margin) const {
+    Room const &r = rooms[room];
+    glm::vec3 in = glm::min(p - r.bounds.min, r.bounds.max - p);
+    if (std::min({in.x, in.y, in.z}) < margin) return true;
+    for (auto const &shared : r.shared) {
+        if (box_contains(shared.expanded(margin), p)) return true;
+    }
+    return false;
+}
+
+uint32_t RoomGraph::update(glm::vec3 p, float margin) {
+    bool jumped = !updated || glm::length(p - last) > margin;
+    last = p;
+    updated = true;
+    if (!jumped && clear && glm::length(p - anchor) < margin) return mask();
+
+    // rooms p may have entered: the neighbours of the ones it was in, or all of them if it was in none
+    // (there are only a handful) or jumped farther than the margin
+    std::vector< uint32_t > candidates;
+    if (jumped || inside.empty()) {
+        for (uint32_t r = 0; r < rooms.size(); r++) candidates.emplace_back(r);
+    } else {
+        for (uint32_t r : inside) {
+            for (uint32_t n : rooms[r].neighbors) candidates.emplace_back(n);
+        }
+    }
+
+    // keep the rooms it is still in (in order), then add the new ones:
+    inside.erase(std::remove_if(inside.begin(), inside.end(), [&](uint32_t r) { return !room_contains(r, p); }),
+                 inside.end());
+    for (uint32_t r : candidates) {
+        if (room_contains(r, p) && std::find(inside.begin(), inside.end(), r) == inside.end()) inside.emplace_back(r);
+    }
+    if (inside.empty() && candidates.size() < rooms.size()) {
+        // left its rooms for one they aren't linked to (rooms with a gap between them but no portal)
+        for (uint32_t r = 0; r < rooms.size(); r++) {
+            if (room_contains(r, p)) inside.emplace_back(r);
+        }
+    }
+
+    anchor = p;
+    clear = true;
+    if (inside.empty()) {
+        for (auto const &room : rooms) {
+            if (box_contains(room.bounds.expanded(margin), p)) clear = false;
+        }
+    } else {
+        for (uint32_t r : inside) {
+            if (near_boundary(r, p, margin)) clear = false;
+        }
+    }
+    return mask();
+}
+
+uint32_t RoomGraph::mask() const {
+    uint32_t bits = 0;
+    for (uint32_t r : inside) bits |= 1u << rooms[r].id;
+    return bits;
+}
+
+std::vector< uint32_t > RoomGraph::hops() const {
+    std::vector< uint32_t > dist(rooms.size(), -1U);
+    std::vector< uint32_t > frontier;
+    for (uint32_t r : inside) {
+        dist[r] = 0;
+        frontier.emplace_back(r);
+    }
+    // breadth-first, one ring of neighbours at a time:
+    for (uint32_t i = 0; i < frontier.size(); i++) {
+        uint32_t r = frontier[i];
+        for (uint32_t n : rooms[r].neighbors) {
+            if (dist[n] != -1U) continue;
+            dist[n] = dist[r] + 1;
+            frontier.emplace_back(n);
+        }
+    }
+    return dist;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Which of a set of axis-aligned room volumes a point is in, kept up to date incrementally.
+//
+// Each room is linked to the rooms whose bounds overlap or touch its own and to the rooms on the other side of
+// its portals (doorway boxes). A point that is farther than 'margin' from every face of its rooms, and from the
+// parts they share with their neighbours, can't be in any other room. So after one full check nothing needs
+// testing until the point has moved 'margin' away from where that check was done. Near a boundary only the
+// current rooms and their neighbours are tested.
+
+#include "AABBTree.hpp"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct RoomGraph {
+    struct Room {
+        uint32_t id = 0;                  // caller's name for it (PlayMode uses RoomType); < 32, see mask()
+        AABB bounds;
+        std::vector< uint32_t > neighbors; // indices into rooms
+        std::vector< AABB > shared;        // bounds intersected with each overlapping neighbour's bounds
+    };
+    std::vector< Room > rooms;
+    std::vector< AABB > portals;
+
+    void add_room(uint32_t id, AABB const &bounds);
+    void add_portal(AABB const &portal);
+    // links the rooms; call after adding them all. Rooms on either side of a portal may be up to 'slack'
+    // away from it (e.g. a doorway cut through a wall that is thicker than the door).
+    void build(float slack);
+
+    // indices of the rooms containing the last updated point, in the order it entered them
+    std::vector< uint32_t > inside;
+    // brings 'inside' up to date for p; returns mask()
+    uint32_t update(glm::vec3 p, float margin);
+    // bit (1 << id) for each room in 'inside'
+    uint32_t mask() const;
+    // for each room, how many neighbour links away from the nearest room in 'inside' it is (-1U if unreachable)
+    std::vector< uint32_t > hops() const;
+
+    //-- internals ---
+    glm::vec3 anchor = glm::vec3(0.f); // where the last full check was done
+    glm::vec3 last = glm::vec3(0.f);   // point of the last update
+    bool clear = false;                // was the anchor at least 'margin' from every boundary?
+    bool updated = false;
+
+    bool room_contains(uint32_t room, glm::vec3 p) const;
+    bool near_boundary(uint32_t room, glm::vec3 p, float margin) const;
+};
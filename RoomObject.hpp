@@ -3,10 +3,9 @@
 #include "Scene.hpp"
 #include "Load.hpp"
 #include "Sound.hpp"
+#include "RigidBody.hpp"
 #include <glm/glm.hpp>
 
-enum SurfaceType {TOP, BOT, FRONT, BACK, LEFT, RIGHT};
-
 enum CollisionType {
 	None,
 	Steal,
@@ -22,6 +21,9 @@ class RoomObject {
 		RoomObject(Scene::Transform *transform_, CollisionType collision_type_) : 
 					transform(transform_), collision_type(collision_type_){
 			this->name = this->transform->name;
+			this->label = this->name.substr(0, this->name.find('.'));
+			if (collision_type == CollisionType::Steal) this->category = Carried | Swattable;
+			else if (collision_type == CollisionType::Destroy) this->category = Solid | Swattable;
 			
             this->capsule.radius = std::max(std::abs(this->transform->bbox[5].x - this->transform->bbox[1].x), 
                                             std::abs(this->transform->bbox[2].y - this->transform->bbox[1].y)) / 2;
@@ -39,9 +41,12 @@ class RoomObject {
 		}
 
 		// ----- Transform properties -----
+		uint32_t id = -1U;	// ObjectStore handle; stable across rooms and held/stolen copies (see CollisionResult::object_id)
+		uint8_t home = 0;	// room it was loaded with (PlayMode::RoomType); its drawables use that room's meshes
 		std::string name;
-		// std::string label;
+		std::string label;	// name up to the first '.', for score messages and held-item frames
 		Scene::Transform *transform = nullptr;
+		Scene::Drawable *held_drawable = nullptr;	// cat-scene frame shown in the mouth while held (looked up by label on pickup)
 		glm::vec3 orig_bbox[8];
         glm::vec3 orig_pos;
 		glm::vec3 orig_scale;
@@ -63,6 +68,24 @@ class RoomObject {
 		bool done = false;
 		glm::vec3 pen_dir = glm::vec3(0);
 		float pen_depth = 0.f;
+
+		// ----- Query filtering (see PlayMode::raycast), copied into the ObjectStore -----
+		enum Flags : uint32_t {
+			CameraTransparent = 1 << 0,	// doesn't pull the camera in (its bbox is much bigger than what is drawn)
+		};
+		uint32_t flags = 0;
+
+		// ----- Query filtering (see PlayMode::capsule_collide), copied into the ObjectStore -----
+		// an object's capsule only hits objects with a category bit in its mask
+		enum Category : uint32_t {
+			Solid		= 1 << 0,	// stops the cat and falling things
+			Carried		= 1 << 1,	// Steal: the cat walks through it and picks it up
+			Swattable	= 1 << 2,	// paw targets
+			ToyBin		= 1 << 3,	// dropping a stolen thing onto it scores
+			Drain		= 1 << 4,	// same, with a splash
+		};
+		uint32_t category = Solid;
+		uint32_t mask = ~0u;
 	
 		// ----- Collision resolution -----
 		std::vector<Scene::Drawable> reaction_drawables;
@@ -76,9 +99,12 @@ class RoomObject {
 		float end_height   = 0.0f;
 		float x_min = 0, x_max = 0, y_min = 0, y_max = 0;
 
-        bool is_moving = false;
-        glm::vec3 move_dir = glm::vec3(0.f);
-        float speed = 0.0f;
-        float given_speed = 0.f;
-        bool spin = false;
+        // ***** Knocked-around objects *****
+        RigidBody body;
+        float given_speed = 0.f;	// how fast the cat's push sends it sliding
+        bool spin = false;		// tumbles while falling
+        // PushOff objects until they land for good, and Steal objects, move under PlayMode's body stepping
+        bool has_body() const {
+            return (collision_type == CollisionType::PushOff && !done) || collision_type == CollisionType::Steal;
+        }
 };
\ No newline at end of file
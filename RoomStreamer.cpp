@@ -0,0 +1,73 @@
+#include "RoomStreamer.hpp"
+
+#include "data_path.hpp"
+
+#include <chrono>
+
+void RoomStreamer::add_room(uint32_t id, std::string const &file) {
+    if (rooms.size() <= id) rooms.resize(id + 1);
+    rooms[id].file = file;
+}
+
+void RoomStreamer::request(uint32_t id) {
+    Room &room = rooms[id];
+    if (room.state != Unloaded) return;
+    room.state = Loading;
+
+    std::string file = room.file;
+    bool read_scene = !room.scene_read;
+    Scene::Drawable::Pipeline drawable_pipeline = pipeline;
+    room.pending = std::async(std::launch::async, [file, read_scene, drawable_pipeline]() {
+        Room::Read read;
+        read.meshes.reset(new MeshBuffer(data_path(file + ".pnct"), data_path(file + ".boundbox"), false));
+        if (read_scene) {
+            MeshBuffer const &meshes = *read.meshes;
+            read.scene.reset(new Scene(data_path(file + ".scene"),
+                    [&](Scene &scene, Scene::Transform *transform, std::string const &mesh_name) {
+                Mesh const &mesh = meshes.lookup(mesh_name);
+                Scene::Drawable &drawable = scene.drawables.emplace_back(transform);
+
+                drawable.pipeline = drawable_pipeline;
+                drawable.pipeline.type = mesh.type;
+                drawable.pipeline.start = mesh.start;
+                drawable.pipeline.count = mesh.count;
+                drawable.min = mesh.min;
+                drawable.max = mesh.max;
+            }));
+        }
+        return read;
+    });
+}
+
+std::vector< uint32_t > RoomStreamer::poll(bool wait) {
+    std::vector< uint32_t > ready;
+    for (uint32_t id = 0; id < rooms.size(); id++) {
+        Room &room = rooms[id];
+        if (room.state != Loading) continue;
+        if (!wait && room.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+
+        Room::Read read = room.pending.get();
+        room.meshes = std::move(read.meshes);
+        room.meshes->upload();
+        room.vao = room.meshes->make_vao_for_program(program);
+        if (read.scene) {
+            room.scene = std::move(read.scene);
+            room.scene_read = true;
+            for (auto &drawable : room.scene->drawables) drawable.pipeline.vao = room.vao;
+        }
+        room.state = Loaded;
+        ready.emplace_back(id);
+    }
+    return ready;
+}
+
+void RoomStreamer::evict(uint32_t id) {
+    Room &room = rooms[id];
+    if (room.state != Loaded) return;
+    glDeleteVertexArrays(1, &room.vao);
+    room.vao = 0;
+    room.meshes.reset();
+    if (room.scene) room.scene_read = false; // never taken: read it again next time
+    room.scene.reset();
+    room.state = Unloaded;
+}
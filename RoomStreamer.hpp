@@ -0,0 +1,55 @@
+#pragma once
+
+// Reads rooms' meshes (and, the first time, their scenes) on a worker thread, so walking toward a room doesn't
+// stall a frame, and frees a room's vertex data again once the caller evicts it.
+//
+// Only file reading and parsing happen off the main thread. Everything that touches OpenGL (uploading the
+// vertex buffer, making the vao) happens in 'poll', which must be called from the thread with the GL context.
+// What a room becoming Loaded means for the game (drawables, objects, colliders) is up to the caller; see
+// PlayMode::install_room.
+
+#include "Mesh.hpp"
+#include "Scene.hpp"
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct RoomStreamer {
+    enum State : uint8_t { Unloaded, Loading, Loaded };
+
+    struct Room {
+        std::string file;                     // data_path(file + ".pnct" / ".boundbox" / ".scene")
+        State state = Unloaded;
+        std::unique_ptr< MeshBuffer > meshes; // uploaded, while Loaded
+        GLuint vao = 0;                       // 'meshes' bound to 'program', while Loaded
+        // the parsed scene, its drawables using 'vao'; only read on the first load. The caller takes it.
+        std::unique_ptr< Scene > scene;
+        bool scene_read = false;
+
+        //-- internals ---
+        struct Read {
+            std::unique_ptr< MeshBuffer > meshes; // not uploaded yet
+            std::unique_ptr< Scene > scene;
+        };
+        std::future< Read > pending;
+    };
+    std::vector< Room > rooms; // indexed by the caller's room id
+
+    // what the rooms' drawables are drawn with (vao/type/start/count are filled in per drawable)
+    Scene::Drawable::Pipeline pipeline;
+    GLuint program = 0;
+
+    void add_room(uint32_t id, std::string const &file);
+    bool loaded(uint32_t id) const { return id < rooms.size() && rooms[id].state == Loaded; }
+
+    // starts reading room 'id' in the background unless it is loaded or already loading
+    void request(uint32_t id);
+    // uploads the rooms whose reads are done (waits for all of them if 'wait'); returns the ids that became Loaded.
+    // note: rethrows anything a read threw (e.g. a missing file).
+    std::vector< uint32_t > poll(bool wait);
+    // frees a Loaded room's vao and vertex data (and its scene, if the caller didn't take it)
+    void evict(uint32_t id);
+};
@@ -5,8 +5,14 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cmath>
 #include <fstream>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SCENE_SSE
+#endif
+
 //-------------------------
 
 glm::mat4x3 Scene::Transform::make_local_to_parent() const {
@@ -56,19 +62,47 @@ glm::mat4x3 Scene::Transform::make_parent_to_local() const {
 	);
 }
 
-glm::mat4x3 Scene::Transform::make_local_to_world() const {
+void Scene::Transform::update() const {
+	bool changed = generation == 0
+		|| position != cached_position || rotation != cached_rotation || scale != cached_scale
+		|| parent != cached_parent;
+	if (parent) {
+		parent->update();
+		if (parent->generation != cached_parent_generation) changed = true;
+	}
+	if (!changed) return;
+
+	cached_position = position;
+	cached_rotation = rotation;
+	cached_scale = scale;
+	cached_parent = parent;
 	if (!parent) {
-		return make_local_to_parent();
+		local_to_world = make_local_to_parent();
+		cached_parent_generation = 0;
 	} else {
-		return parent->make_local_to_world() * glm::mat4(make_local_to_parent()); //note: glm::mat4(glm::mat4x3) pads with a (0,0,0,1) row
+		local_to_world = parent->local_to_world * glm::mat4(make_local_to_parent()); //note: glm::mat4(glm::mat4x3) pads with a (0,0,0,1) row
+		cached_parent_generation = parent->generation;
 	}
+	world_to_local_valid = false;
+	generation += 1;
+	if (generation == 0) generation = 1; //(0 is reserved for "never computed")
 }
-glm::mat4x3 Scene::Transform::make_world_to_local() const {
-	if (!parent) {
-		return make_parent_to_local();
-	} else {
-		return make_parent_to_local() * glm::mat4(parent->make_world_to_local()); //note: glm::mat4(glm::mat4x3) pads with a (0,0,0,1) row
+
+glm::mat4x3 const &Scene::Transform::make_local_to_world() const {
+	update();
+	return local_to_world;
+}
+glm::mat4x3 const &Scene::Transform::make_world_to_local() const {
+	update();
+	if (!world_to_local_valid) {
+		if (!parent) {
+			world_to_local = make_parent_to_local();
+		} else {
+			world_to_local = make_parent_to_local() * glm::mat4(parent->make_world_to_local()); //note: glm::mat4(glm::mat4x3) pads with a (0,0,0,1) row
+		}
+		world_to_local_valid = true;
 	}
+	return world_to_local;
 }
 
 //-------------------------
@@ -79,17 +113,95 @@ glm::mat4 Scene::Camera::make_projection() const {
 
 //-------------------------
 
+Scene::Frustum::Frustum(glm::mat4 const &world_to_clip) {
+	//a point is in view when -w <= x,y,z <= w in clip space; each of those is a plane in world space
+	// (Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"):
+	glm::vec4 row[4];
+	for (uint32_t r = 0; r < 4; ++r) {
+		row[r] = glm::vec4(world_to_clip[0][r], world_to_clip[1][r], world_to_clip[2][r], world_to_clip[3][r]);
+	}
+	glm::vec4 planes[8] = {
+		row[3] + row[0], row[3] - row[0],
+		row[3] + row[1], row[3] - row[1],
+		row[3] + row[2], row[3] - row[2], //n.b. the far plane of an infinite projection is all-zero but w, so passes everything
+		glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+	};
+	for (uint32_t i = 0; i < 8; ++i) {
+		x[i] = planes[i].x;
+		y[i] = planes[i].y;
+		z[i] = planes[i].z;
+		w[i] = planes[i].w;
+	}
+}
 
-void Scene::draw(Camera const &camera) const {
+bool Scene::Frustum::overlaps(glm::vec3 const &min, glm::vec3 const &max, glm::mat4x3 const &object_to_world) const {
+	if (!(min.x <= max.x && min.y <= max.y && min.z <= max.z)) return true;
+
+	//world-space box around the transformed box (Arvo, "Transforming Axis-Aligned Bounding Boxes"):
+	glm::vec3 center = object_to_world * glm::vec4(0.5f * (min + max), 1.0f);
+	glm::vec3 half = 0.5f * (max - min);
+	glm::vec3 extent = glm::abs(object_to_world[0]) * half.x
+	                 + glm::abs(object_to_world[1]) * half.y
+	                 + glm::abs(object_to_world[2]) * half.z;
+
+	//the box is out of view if it is entirely behind any plane, i.e., its center is further behind than
+	// the box reaches toward the plane's normal:
+#ifdef SCENE_SSE
+	__m128 const cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+	__m128 const ex = _mm_set1_ps(extent.x), ey = _mm_set1_ps(extent.y), ez = _mm_set1_ps(extent.z);
+	__m128 const sign = _mm_set1_ps(-0.0f);
+	for (uint32_t i = 0; i < 8; i += 4) {
+		__m128 px = _mm_load_ps(x + i), py = _mm_load_ps(y + i), pz = _mm_load_ps(z + i);
+		__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)),
+			_mm_add_ps(_mm_mul_ps(pz, cz), _mm_load_ps(w + i)));
+		__m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign, px), ex), _mm_mul_ps(_mm_andnot_ps(sign, py), ey)),
+			_mm_mul_ps(_mm_andnot_ps(sign, pz), ez));
+		if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, reach), _mm_setzero_ps()))) return false;
+	}
+#else
+	for (uint32_t i = 0; i < 8; ++i) {
+		float dist = x[i] * center.x + y[i] * center.y + z[i] * center.z + w[i];
+		float reach = std::abs(x[i]) * extent.x + std::abs(y[i]) * extent.y + std::abs(z[i]) * extent.z;
+		if (dist + reach < 0.0f) return false;
+	}
+#endif
+	return true;
+}
+
+//-------------------------
+
+
+void Scene::update_transforms() const {
+	//(update() refreshes a transform's parent first, so the order of the pool doesn't matter):
+	for (auto const &transform : transforms) {
+		transform.update();
+	}
+}
+
+void Scene::draw(Camera const &camera, uint32_t partitions) const {
 	assert(camera.transform);
 	glm::mat4 world_to_clip = camera.make_projection() * glm::mat4(camera.transform->make_world_to_local());
 	glm::mat4x3 world_to_light = glm::mat4x3(1.0f);
-	draw(world_to_clip, world_to_light);
+	draw(world_to_clip, world_to_light, partitions);
 }
 
-void Scene::draw(glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_light) const {
+void Scene::draw(glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_light, uint32_t partitions) const {
+
+	Frustum frustum(world_to_clip);
+	draw_stats = DrawStats();
 
 	for (auto const &drawable : drawables) {
+		//skip drawables in parts of the scene that aren't wanted:
+		if (!(partitions & (1u << drawable.partition))) continue;
+		//skip drawables that are switched off:
+		if (drawable.hidden) continue;
+		//skip drawables that are out of view:
+		assert(drawable.transform); //drawables *must* have a transform
+		if (!frustum.overlaps(drawable)) {
+			draw_stats.culled += 1;
+			continue;
+		}
+
 		//Reference to drawable's pipeline for convenience:
 		Scene::Drawable::Pipeline const &pipeline = drawable.pipeline;
 
@@ -109,7 +221,6 @@ void Scene::draw(glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_lig
 		//Configure program uniforms:
 
 		//the object-to-world matrix is used in all three of these uniforms:
-		assert(drawable.transform); //drawables *must* have a transform
 		glm::mat4x3 object_to_world = drawable.transform->make_local_to_world();
 
 		//OBJECT_TO_CLIP takes vertices from object space to clip space:
@@ -145,6 +256,7 @@ void Scene::draw(glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_lig
 
 		//draw the object:
 		glDrawArrays(pipeline.type, pipeline.start, pipeline.count);
+		draw_stats.drawn += 1;
 
 		//un-bind textures:
 		for (uint32_t i = 0; i < Drawable::Pipeline::TextureCount; ++i) {
@@ -222,8 +334,7 @@ void Scene::load(std::string const &filename,
 	hierarchy_transforms.reserve(hierarchy.size());
 
 	for (auto const &h : hierarchy) {
-		transforms.emplace_back();
-		Transform *t = &transforms.back();
+		Transform *t = &transforms.emplace_back();
 		if (h.parent != -1U) {
 			if (h.parent >= hierarchy_transforms.size()) {
 				throw std::runtime_error("scene file '" + filename + "' did not contain transforms in topological-sort order.");
@@ -268,8 +379,7 @@ void Scene::load(std::string const &filename,
 			std::cout << "Ignoring non-perspective camera (" + std::string(c.type, 4) + ") stored in file." << std::endl;
 			continue;
 		}
-		this->cameras.emplace_back(hierarchy_transforms[c.transform]);
-		Camera *camera = &this->cameras.back();
+		Camera *camera = &this->cameras.emplace_back(hierarchy_transforms[c.transform]);
 		camera->fovy = c.data / 180.0f * 3.1415926f; //FOV is stored in degrees; convert to radians.
 		camera->near = c.clip_near;
 		//N.b. far plane is ignored because cameras use infinite perspective matrices.
@@ -291,8 +401,7 @@ void Scene::load(std::string const &filename,
 			std::cout << "Ignoring unrecognized lamp type (" + std::string(&l.type, 1) + ") stored in file." << std::endl;
 			continue;
 		}
-		this->lights.emplace_back(hierarchy_transforms[l.transform]);
-		Light *light = &this->lights.back();
+		Light *light = &this->lights.emplace_back(hierarchy_transforms[l.transform]);
 		light->type = static_cast<Light::Type>(l.type);
 		light->energy = glm::vec3(l.color) / 255.0f * l.energy;
 		light->spot_fov = l.fov / 180.0f * 3.1415926f; //FOV is stored in degrees; convert to radians.
@@ -324,51 +433,54 @@ Scene &Scene::operator=(Scene const &other) {
 	return *this;
 }
 
-void Scene::set(Scene const &other, std::unordered_map< Transform const *, Transform * > *transform_map_) {
-
-	std::unordered_map< Transform const *, Transform * > t2t_temp;
-	std::unordered_map< Transform const *, Transform * > &transform_to_transform = *(transform_map_ ? transform_map_ : &t2t_temp);
-
-	transform_to_transform.clear();
+void Scene::set(Scene const &other, std::unordered_map< Transform const *, Transform * > *transform_map) {
 
-	//null transform maps to itself:
-	transform_to_transform.insert(std::make_pair(nullptr, nullptr));
+	//Copy transforms, remembering where each one went by other's slot index:
+	std::vector< Transform * > remap(other.transforms.slot_count(), nullptr);
+	auto to_new = [&](Transform const *t) -> Transform * {
+		return t ? remap[other.transforms.index_of(t)] : nullptr;
+	};
 
-	//Copy transforms and store mapping:
 	transforms.clear();
 	for (auto const &t : other.transforms) {
-		transforms.emplace_back();
-		transforms.back().name = t.name;
-		transforms.back().position = t.position;
-		transforms.back().rotation = t.rotation;
-		transforms.back().scale = t.scale;
-		transforms.back().parent = t.parent; //will update later
-
-		//store mapping between transforms old and new:
-		auto ret = transform_to_transform.insert(std::make_pair(&t, &transforms.back()));
-		assert(ret.second);
+		Transform &copy = transforms.emplace_back();
+		copy.name = t.name;
+		copy.position = t.position;
+		copy.rotation = t.rotation;
+		copy.scale = t.scale;
+		copy.parent = t.parent; //will update later
+		remap[other.transforms.index_of(&t)] = &copy;
 	}
 
 	//update transform parents:
 	for (auto &t : transforms) {
-		t.parent = transform_to_transform.at(t.parent);
+		t.parent = to_new(t.parent);
+	}
+
+	if (transform_map) {
+		transform_map->clear();
+		//null transform maps to itself:
+		transform_map->insert(std::make_pair(nullptr, nullptr));
+		for (auto const &t : other.transforms) {
+			transform_map->insert(std::make_pair(&t, to_new(&t)));
+		}
 	}
 
 	//copy other's drawables, updating transform pointers:
 	drawables = other.drawables;
 	for (auto &d : drawables) {
-		d.transform = transform_to_transform.at(d.transform);
+		d.transform = to_new(d.transform);
 	}
 
 	//copy other's cameras, updating transform pointers:
 	cameras = other.cameras;
 	for (auto &c : cameras) {
-		c.transform = transform_to_transform.at(c.transform);
+		c.transform = to_new(c.transform);
 	}
 
 	//copy other's lights, updating transform pointers:
 	lights = other.lights;
 	for (auto &l : lights) {
-		l.transform = transform_to_transform.at(l.transform);
+		l.transform = to_new(l.transform);
 	}
 }
@@ -11,11 +11,12 @@
  */
 
 #include "GL.hpp"
+#include "Pool.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
-#include <list>
+#include <limits>
 #include <memory>
 #include <functional>
 #include <string>
@@ -52,8 +53,24 @@ struct Scene {
 		glm::mat4x3 make_local_to_parent() const;
 		glm::mat4x3 make_parent_to_local() const;
 		// ..relative to the world:
-		glm::mat4x3 make_local_to_world() const;
-		glm::mat4x3 make_world_to_local() const;
+		// (cached; recomputed only when position/rotation/scale/parent or an ancestor changed since the last call)
+		glm::mat4x3 const &make_local_to_world() const;
+		glm::mat4x3 const &make_world_to_local() const;
+
+		//bring the cached matrices up to date (make_*_to_world/local do this themselves):
+		void update() const;
+
+		//-- internals: matrix cache ---
+		//the local transformation (and parent) the cache was computed from; NaN so the first update() computes:
+		mutable glm::vec3 cached_position = glm::vec3(std::numeric_limits< float >::quiet_NaN());
+		mutable glm::quat cached_rotation;
+		mutable glm::vec3 cached_scale;
+		mutable Transform const *cached_parent = nullptr;
+		mutable uint32_t cached_parent_generation = 0;
+		mutable uint32_t generation = 0; //bumped each time local_to_world changes (0: never computed)
+		mutable glm::mat4x3 local_to_world;
+		mutable glm::mat4x3 world_to_local;
+		mutable bool world_to_local_valid = false; //computed on demand
 
 		//since hierarchy is tracked through pointers, copy-constructing a transform  is not advised:
 		Transform(Transform const &) = delete;
@@ -65,6 +82,11 @@ struct Scene {
 		//a 'Drawable' attaches attribute data to a transform:
 		Drawable(Transform *transform_) : transform(transform_) { assert(transform); }
 		Transform * transform;
+		uint32_t partition = 0; //which part of a larger scene it belongs to; see draw()'s 'partitions'
+		bool hidden = false; //skipped by draw() (e.g. animation frames that aren't showing)
+		//object-space bounding box of what the pipeline draws, for culling (min > max means unknown: never culled):
+		glm::vec3 min = glm::vec3( std::numeric_limits< float >::infinity());
+		glm::vec3 max = glm::vec3(-std::numeric_limits< float >::infinity());
 
 		//Contains all the data needed to run the OpenGL pipeline:
 		struct Pipeline {
@@ -129,16 +151,46 @@ struct Scene {
 	};
 
 	//Scenes, of course, may have many of the above objects:
-	std::list< Transform > transforms;
-	std::list< Drawable > drawables;
-	std::list< Camera > cameras;
-	std::list< Light > lights;
+	// (kept in chunked pools, so pointers to them stay valid and iteration walks contiguous memory; see Pool.hpp)
+	Pool< Transform > transforms;
+	Pool< Drawable > drawables;
+	Pool< Camera > cameras;
+	Pool< Light > lights;
+
+	//Refresh every transform's cached matrices in one pass, parents first
+	// (optional -- reading a matrix refreshes it -- but cheap to do once a frame before drawing):
+	void update_transforms() const;
 
 	//The "draw" function provides a convenient way to pass all the things in a scene to OpenGL:
-	void draw(Camera const &camera) const;
+	// (only drawables whose bit (1 << partition) is set in 'partitions' are drawn)
+	// (drawables whose bounds are outside the view are skipped before any GL calls)
+	void draw(Camera const &camera, uint32_t partitions = ~0u) const;
 
 	//..sometimes, you want to draw with a custom projection matrix and/or light space:
-	void draw(glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_light = glm::mat4x3(1.0f)) const;
+	void draw(glm::mat4 const &world_to_clip, glm::mat4x3 const &world_to_light = glm::mat4x3(1.0f), uint32_t partitions = ~0u) const;
+
+	//what the last draw() did:
+	struct DrawStats {
+		uint32_t drawn = 0;
+		uint32_t culled = 0; //outside the view volume
+	};
+	mutable DrawStats draw_stats;
+
+	//The view volume of a world_to_clip matrix, for skipping drawables that can't be seen:
+	struct Frustum {
+		Frustum(glm::mat4 const &world_to_clip);
+
+		//might any part of the box min..max (in the space object_to_world maps from) be in view?
+		// (conservative: boxes near the frustum's corners may pass; unknown bounds (min > max) always pass)
+		bool overlaps(glm::vec3 const &min, glm::vec3 const &max, glm::mat4x3 const &object_to_world) const;
+		bool overlaps(Drawable const &drawable) const {
+			return overlaps(drawable.min, drawable.max, drawable.transform->make_local_to_world());
+		}
+
+		//planes (left, right, bottom, top, near, far, and two that pass everything) as x*p.x + y*p.y + z*p.z + w >= 0,
+		// stored one component per array so four planes are tested at once:
+		alignas(16) float x[8], y[8], z[8], w[8];
+	};
 
 	//add transforms/objects/cameras from a scene file to this scene:
 	// the 'on_drawable' callback gives your code a chance to look up mesh data and make Drawables:
@@ -0,0 +1,523 @@
+//collision-bench: times the collision routines on seeded random fixtures and prints JSON
+// usage: collision-bench [--seed N] [--count N] [--time seconds]
+//
+//Every routine is run against four fixture sets: 'hit' (clearly overlapping), 'miss' (clearly
+// apart), 'edge' (near an edge or corner, so roughly half hit) and 'parallel' (capsule lying
+// parallel to the surface it is tested against). Results are meant to be diffed run to run.
+//Exits with status 1 if a batched kernel disagrees with its scalar reference.
+
+#include "Collision.hpp"
+#include "AABBTree.hpp"
+#include "MeshCollider.hpp"
+#include "ConvexHull.hpp"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Bench {
+	std::mt19937 rng;
+	uint32_t count = 4096; //fixtures per set
+	double min_time = 0.25; //seconds to spend timing each routine/fixture pair
+
+	float uniform(float lo, float hi) { return std::uniform_real_distribution< float >(lo, hi)(rng); }
+	glm::vec3 point(float extent) { return glm::vec3(uniform(-extent, extent), uniform(-extent, extent), uniform(-extent, extent)); }
+	glm::vec3 direction() {
+		while (true) {
+			glm::vec3 v = point(1.0f);
+			float len2 = glm::dot(v, v);
+			if (len2 > 0.01f && len2 <= 1.0f) return v / std::sqrt(len2);
+		}
+	}
+	//any unit vector perpendicular to 'n':
+	glm::vec3 perpendicular(glm::vec3 n) {
+		while (true) {
+			glm::vec3 v = direction();
+			v -= glm::dot(v, n) * n;
+			if (glm::dot(v, v) > 0.01f) return glm::normalize(v);
+		}
+	}
+
+	struct Result {
+		std::string routine;
+		std::string fixture;
+		uint64_t queries = 0;
+		double seconds = 0.0;
+		uint64_t hits = 0;
+	};
+	std::vector< Result > results;
+	bool failed = false; //a routine disagreed with its reference; exit non-zero
+
+	//run 'fn(fixture)' (returns true on hit) over all fixtures until min_time has passed:
+	template< typename Fixture, typename F >
+	void run(std::string const &routine, std::string const &fixture, std::vector< Fixture > const &fixtures, F const &fn) {
+		//warm up caches and count hits once:
+		uint64_t hits = 0;
+		for (auto const &f : fixtures) hits += fn(f) ? 1 : 0;
+
+		Result result;
+		result.routine = routine;
+		result.fixture = fixture;
+		auto before = std::chrono::steady_clock::now();
+		uint64_t sink = 0;
+		do {
+			for (auto const &f : fixtures) sink += fn(f) ? 1 : 0;
+			result.queries += fixtures.size();
+			result.seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - before).count();
+		} while (result.seconds < min_time);
+		//every pass sees the same fixtures, so the hit count must repeat:
+		if (sink != hits * (result.queries / fixtures.size())) {
+			std::cerr << "WARNING: " << routine << "/" << fixture << " is not deterministic." << std::endl;
+		}
+		result.hits = hits * (result.queries / fixtures.size());
+		results.emplace_back(result);
+	}
+
+	void print_json(std::ostream &out, uint32_t seed) const {
+		out << "{\n";
+		out << "\t\"seed\": " << seed << ",\n";
+		out << "\t\"fixtures_per_set\": " << count << ",\n";
+		out << "\t\"results\": [\n";
+		for (uint32_t i = 0; i < results.size(); ++i) {
+			Result const &r = results[i];
+			double ns = r.seconds * 1e9 / double(r.queries);
+			out << "\t\t{ \"routine\": \"" << r.routine << "\", \"fixture\": \"" << r.fixture << "\""
+			    << ", \"queries\": " << r.queries
+			    << ", \"ns_per_query\": " << ns
+			    << ", \"queries_per_second\": " << (1e9 / ns)
+			    << ", \"hit_rate\": " << (double(r.hits) / double(r.queries))
+			    << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		out << "\t]\n";
+		out << "}\n";
+	}
+};
+
+//------------ fixtures ------------
+
+struct Triangle {
+	glm::vec3 p0, p1, p2;
+	glm::vec3 normal() const { return glm::normalize(glm::cross(p1 - p0, p2 - p0)); }
+};
+
+struct SphereTriangle {
+	Triangle tri;
+	glm::vec3 center;
+	float radius;
+};
+
+struct CapsuleShape {
+	glm::vec3 tip, base;
+	float radius;
+};
+
+struct CapsuleTriangle {
+	Triangle tri;
+	CapsuleShape capsule;
+};
+
+//eight corners in the same order as Scene::Transform::bbox (Blender's bound_box order):
+struct Box {
+	glm::vec3 corners[8];
+	OrientedBox obb;
+	TriangleBatch batches[3];
+	ConvexHull hull; //of the corners, so hull and box results are comparable
+};
+
+struct CapsuleBox {
+	Box const *box;
+	CapsuleShape capsule;
+};
+
+struct CapsuleCapsule {
+	CapsuleShape a, b;
+};
+
+enum FixtureKind { Hit, Miss, Edge, Parallel };
+static char const *fixture_names[] = { "hit", "miss", "edge", "parallel" };
+
+static Triangle make_triangle(Bench &bench) {
+	Triangle tri;
+	do {
+		glm::vec3 center = bench.point(2.0f);
+		tri.p0 = center + bench.point(1.0f);
+		tri.p1 = center + bench.point(1.0f);
+		tri.p2 = center + bench.point(1.0f);
+		glm::vec3 c = glm::cross(tri.p1 - tri.p0, tri.p2 - tri.p0);
+		if (glm::dot(c, c) > 0.05f) break;
+	} while (true);
+	return tri;
+}
+
+static glm::vec3 point_in_triangle(Bench &bench, Triangle const &tri) {
+	float u = bench.uniform(0.05f, 0.9f);
+	float v = bench.uniform(0.05f, 0.95f - u);
+	return tri.p0 + u * (tri.p1 - tri.p0) + v * (tri.p2 - tri.p0);
+}
+
+static glm::vec3 point_on_edge(Bench &bench, Triangle const &tri) {
+	glm::vec3 const *pts[3] = { &tri.p0, &tri.p1, &tri.p2 };
+	uint32_t e = std::uniform_int_distribution< uint32_t >(0, 2)(bench.rng);
+	float t = bench.uniform(0.0f, 1.0f);
+	return *pts[e] + t * (*pts[(e + 1) % 3] - *pts[e]);
+}
+
+//capsule with its segment axis along 'axis' and its closest-approach sphere centered at 'center':
+static CapsuleShape capsule_at(glm::vec3 center, glm::vec3 axis, float radius, float half_length) {
+	CapsuleShape c;
+	c.radius = radius;
+	c.base = center - axis * (half_length + radius);
+	c.tip = center + axis * (half_length + radius);
+	return c;
+}
+
+static std::vector< SphereTriangle > make_sphere_triangle(Bench &bench, FixtureKind kind) {
+	std::vector< SphereTriangle > fixtures;
+	while (fixtures.size() < bench.count) {
+		SphereTriangle f;
+		f.tri = make_triangle(bench);
+		f.radius = bench.uniform(0.1f, 0.5f);
+		glm::vec3 n = f.tri.normal();
+		if (kind == Hit) {
+			f.center = point_in_triangle(bench, f.tri) + n * bench.uniform(-0.5f, 0.5f) * f.radius;
+		} else if (kind == Miss) {
+			f.center = point_in_triangle(bench, f.tri) + n * bench.uniform(1.5f, 3.0f) * f.radius * (bench.uniform(-1.0f, 1.0f) < 0.0f ? -1.0f : 1.0f);
+		} else if (kind == Edge) {
+			f.center = point_on_edge(bench, f.tri) + bench.direction() * bench.uniform(0.5f, 1.5f) * f.radius;
+		} else {
+			//sphere centered in the triangle's plane:
+			f.center = point_in_triangle(bench, f.tri) + bench.perpendicular(n) * bench.uniform(0.0f, 1.0f);
+		}
+		fixtures.emplace_back(f);
+	}
+	return fixtures;
+}
+
+static std::vector< CapsuleTriangle > make_capsule_triangle(Bench &bench, FixtureKind kind) {
+	std::vector< CapsuleTriangle > fixtures;
+	while (fixtures.size() < bench.count) {
+		CapsuleTriangle f;
+		f.tri = make_triangle(bench);
+		float r = bench.uniform(0.1f, 0.5f);
+		float half = bench.uniform(0.0f, 1.0f);
+		glm::vec3 n = f.tri.normal();
+		if (kind == Hit) {
+			f.capsule = capsule_at(point_in_triangle(bench, f.tri), bench.direction(), r, half);
+		} else if (kind == Miss) {
+			glm::vec3 side = (bench.uniform(-1.0f, 1.0f) < 0.0f ? -n : n);
+			glm::vec3 axis = bench.direction();
+			//move far enough that the whole capsule is off the plane:
+			float lift = (half + r) * std::abs(glm::dot(axis, n)) + r * bench.uniform(1.5f, 3.0f);
+			f.capsule = capsule_at(point_in_triangle(bench, f.tri) + side * lift, axis, r, half);
+		} else if (kind == Edge) {
+			glm::vec3 c = point_on_edge(bench, f.tri) + bench.direction() * bench.uniform(0.5f, 1.5f) * r;
+			f.capsule = capsule_at(c, bench.perpendicular(n), r, half);
+		} else {
+			//exactly parallel to the plane (capsule_triangle_collision's parallel branch):
+			glm::vec3 c = point_in_triangle(bench, f.tri) + n * bench.uniform(-0.9f, 0.9f) * r;
+			CapsuleShape cap;
+			cap.radius = r;
+			glm::vec3 axis = glm::normalize(f.tri.p1 - f.tri.p0);
+			cap.base = c - axis * (half + r);
+			cap.tip = c + axis * (half + r);
+			f.capsule = cap;
+		}
+		fixtures.emplace_back(f);
+	}
+	return fixtures;
+}
+
+static std::vector< Box > make_boxes(Bench &bench, uint32_t count) {
+	static int const signs[8][3] = {
+		{-1,-1,-1}, {-1,-1, 1}, {-1, 1, 1}, {-1, 1,-1},
+		{ 1,-1,-1}, { 1,-1, 1}, { 1, 1, 1}, { 1, 1,-1},
+	};
+	std::vector< Box > boxes(count);
+	for (auto &box : boxes) {
+		glm::vec3 x = bench.direction();
+		glm::vec3 y = bench.perpendicular(x);
+		glm::vec3 z = glm::cross(x, y);
+		glm::vec3 center = bench.point(3.0f);
+		glm::vec3 half = glm::vec3(bench.uniform(0.1f, 1.0f), bench.uniform(0.1f, 1.0f), bench.uniform(0.1f, 1.0f));
+		for (uint32_t i = 0; i < 8; ++i) {
+			box.corners[i] = center
+				+ float(signs[i][0]) * half.x * x
+				+ float(signs[i][1]) * half.y * y
+				+ float(signs[i][2]) * half.z * z;
+		}
+		box.obb = make_oriented_box(box.corners);
+		make_bbox_batches(box.corners, box.batches);
+		box.hull.build(box.corners, 8, glm::mat4x3(1.0f));
+	}
+	return boxes;
+}
+
+static std::vector< CapsuleBox > make_capsule_box(Bench &bench, std::vector< Box > const &boxes, FixtureKind kind) {
+	std::vector< CapsuleBox > fixtures;
+	while (fixtures.size() < bench.count) {
+		CapsuleBox f;
+		f.box = &boxes[fixtures.size() % boxes.size()];
+		OrientedBox const &obb = f.box->obb;
+		float r = bench.uniform(0.1f, 0.4f);
+		float half = bench.uniform(0.0f, 0.8f);
+
+		//random point on the box surface, with the outward normal of its face:
+		uint32_t axis = std::uniform_int_distribution< uint32_t >(0, 2)(bench.rng);
+		float side = (bench.uniform(-1.0f, 1.0f) < 0.0f ? -1.0f : 1.0f);
+		glm::vec3 local = glm::vec3(bench.uniform(-1.0f, 1.0f), bench.uniform(-1.0f, 1.0f), bench.uniform(-1.0f, 1.0f)) * obb.half;
+		local[axis] = side * obb.half[axis];
+		glm::vec3 surface = obb.center + local.x * obb.axis[0] + local.y * obb.axis[1] + local.z * obb.axis[2];
+		glm::vec3 n = side * obb.axis[axis];
+
+		if (kind == Hit) {
+			f.capsule = capsule_at(surface + n * bench.uniform(-0.5f, 0.5f) * r, bench.direction(), r, half);
+		} else if (kind == Miss) {
+			float reach = glm::length(obb.half) + half + r;
+			f.capsule = capsule_at(obb.center + bench.direction() * reach * bench.uniform(1.2f, 2.0f), bench.direction(), r, half);
+		} else if (kind == Edge) {
+			//near a corner:
+			glm::vec3 corner = f.box->corners[std::uniform_int_distribution< uint32_t >(0, 7)(bench.rng)];
+			glm::vec3 out = glm::normalize(corner - obb.center);
+			f.capsule = capsule_at(corner + out * bench.uniform(0.5f, 1.5f) * r, bench.perpendicular(out), r, half);
+		} else {
+			//lying along the face it is touching:
+			f.capsule = capsule_at(surface + n * bench.uniform(0.0f, 0.9f) * r, obb.axis[(axis + 1) % 3], r, half);
+		}
+		fixtures.emplace_back(f);
+	}
+	return fixtures;
+}
+
+static std::vector< CapsuleCapsule > make_capsule_capsule(Bench &bench, FixtureKind kind) {
+	std::vector< CapsuleCapsule > fixtures;
+	while (fixtures.size() < bench.count) {
+		CapsuleCapsule f;
+		float ra = bench.uniform(0.1f, 0.5f);
+		float rb = bench.uniform(0.1f, 0.5f);
+		glm::vec3 center = bench.point(2.0f);
+		glm::vec3 axis = bench.direction();
+		f.a = capsule_at(center, axis, ra, bench.uniform(0.1f, 1.0f));
+		if (kind == Hit) {
+			f.b = capsule_at(center + bench.direction() * bench.uniform(0.0f, 0.5f) * (ra + rb), bench.direction(), rb, bench.uniform(0.1f, 1.0f));
+		} else if (kind == Miss) {
+			float reach = glm::distance(f.a.tip, f.a.base) + ra + 2.0f * rb + 1.0f;
+			glm::vec3 c = center + bench.direction() * reach * bench.uniform(1.0f, 2.0f);
+			f.b = capsule_at(c, bench.direction(), rb, 0.0f);
+		} else if (kind == Edge) {
+			//end to end:
+			glm::vec3 c = f.a.tip + bench.direction() * bench.uniform(0.5f, 1.5f) * rb;
+			f.b = capsule_at(c, bench.direction(), rb, 0.0f);
+		} else {
+			glm::vec3 c = center + bench.perpendicular(axis) * bench.uniform(0.5f, 1.5f) * (ra + rb);
+			f.b = capsule_at(c, axis, rb, bench.uniform(0.1f, 1.0f));
+		}
+		fixtures.emplace_back(f);
+	}
+	return fixtures;
+}
+
+//------------ main ------------
+
+int main(int argc, char **argv) {
+	uint32_t seed = 0x5eed;
+	Bench bench;
+	for (int argi = 1; argi < argc; ++argi) {
+		std::string arg = argv[argi];
+		if (arg == "--seed" && argi + 1 < argc) {
+			seed = uint32_t(std::strtoul(argv[++argi], nullptr, 10));
+		} else if (arg == "--count" && argi + 1 < argc) {
+			bench.count = std::max(1u, uint32_t(std::strtoul(argv[++argi], nullptr, 10)));
+		} else if (arg == "--time" && argi + 1 < argc) {
+			bench.min_time = std::atof(argv[++argi]);
+		} else {
+			std::cerr << "Usage:\n\t" << argv[0] << " [--seed N] [--count N] [--time seconds]" << std::endl;
+			return 1;
+		}
+	}
+	bench.rng.seed(seed);
+
+	std::vector< Box > boxes = make_boxes(bench, 256);
+
+	for (FixtureKind kind : { Hit, Miss, Edge, Parallel }) {
+		std::string name = fixture_names[kind];
+		glm::vec3 normal;
+		float depth;
+
+		auto sphere_tri = make_sphere_triangle(bench, kind);
+		bench.run("sphere_triangle_collision", name, sphere_tri, [&](SphereTriangle const &f) {
+			return sphere_triangle_collision(f.center, f.radius, f.tri.p0, f.tri.p1, f.tri.p2, &normal, &depth);
+		});
+
+		auto capsule_tri = make_capsule_triangle(bench, kind);
+		bench.run("capsule_triangle_collision", name, capsule_tri, [&](CapsuleTriangle const &f) {
+			return capsule_triangle_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.tri.p0, f.tri.p1, f.tri.p2, &normal, &depth);
+		});
+
+		auto capsule_box = make_capsule_box(bench, boxes, kind);
+		//(only the box's top face, so about a sixth of the 'hit' fixtures touch it directly)
+		bench.run("capsule_rectagle_collision", name, capsule_box, [&](CapsuleBox const &f) {
+			glm::vec3 const *p = f.box->corners;
+			return capsule_rectagle_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, p[6], p[5], p[1], p[2], &normal, &depth);
+		});
+		bench.run("capsule_bbox_collision", name, capsule_box, [&](CapsuleBox const &f) {
+			SurfaceType surface;
+			return capsule_bbox_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->corners, &surface, &normal, &depth);
+		});
+		bench.run("capsule_bbox_collision(prebuilt)", name, capsule_box, [&](CapsuleBox const &f) {
+			CollisionResult result;
+			return capsule_bbox_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->obb, &result);
+		});
+		{ //same queries again, each fixture keeping its own cached face (warmed by the first pass):
+			ContactCache cache;
+			bench.run("capsule_obb_collision(cached)", name, capsule_box, [&](CapsuleBox const &f) {
+				CollisionResult result;
+				uint32_t object_id = uint32_t(&f - capsule_box.data());
+				return capsule_obb_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->obb, &cache, 0, object_id, &result);
+			});
+		}
+		//same capsules lifted up and dropped back through their fixture position:
+		bench.run("capsule_obb_sweep", name, capsule_box, [&](CapsuleBox const &f) {
+			glm::vec3 lift(0.0f, 0.0f, 1.5f);
+			CollisionResult result;
+			float toi;
+			return capsule_obb_sweep(f.capsule.tip + lift, f.capsule.base + lift, f.capsule.radius, -2.0f * lift, f.box->obb, &toi, &result);
+		});
+		bench.run("capsule_hull_collision", name, capsule_box, [&](CapsuleBox const &f) {
+			CollisionResult result;
+			return capsule_hull_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->hull, &result);
+		});
+		//bbox faces as twelve triangles, through the batched kernel and its scalar reference:
+		bench.run("capsule_triangle_batch_collision", name, capsule_box, [&](CapsuleBox const &f) {
+			CollisionResult result;
+			uint32_t index;
+			return capsule_triangle_batch_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->batches, 3, &result, &index);
+		});
+		bench.run("capsule_triangle_batch_collision_scalar", name, capsule_box, [&](CapsuleBox const &f) {
+			CollisionResult result;
+			uint32_t index;
+			return capsule_triangle_batch_collision_scalar(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->batches, 3, &result, &index);
+		});
+		{ //the batched kernel must agree with its scalar reference on every fixture:
+			uint32_t mismatches = 0;
+			for (auto const &f : capsule_box) {
+				CollisionResult a, b;
+				uint32_t a_index = -1U, b_index = -1U;
+				bool a_hit = capsule_triangle_batch_collision(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->batches, 3, &a, &a_index);
+				bool b_hit = capsule_triangle_batch_collision_scalar(f.capsule.tip, f.capsule.base, f.capsule.radius, f.box->batches, 3, &b, &b_index);
+				if (a_hit != b_hit) mismatches += 1;
+				else if (a_hit && (a_index != b_index
+					|| std::abs(a.depth - b.depth) > 1e-4f
+					|| glm::length(a.normal - b.normal) > 1e-4f)) mismatches += 1;
+			}
+			if (mismatches) {
+				std::cerr << "WARNING: capsule_triangle_batch_collision/" << name << " differs from the scalar reference on "
+				          << mismatches << " of " << capsule_box.size() << " fixtures." << std::endl;
+				bench.failed = true;
+			}
+		}
+
+		auto capsule_capsule = make_capsule_capsule(bench, kind);
+		bench.run("capsule_capsule_collision", name, capsule_capsule, [&](CapsuleCapsule const &f) {
+			return capsule_capsule_collision(f.a.radius, f.a.tip, f.a.base, f.b.radius, f.b.tip, f.b.base);
+		});
+	}
+
+	{ //hull vs hull: consecutive boxes from the shared set (mostly apart, a few percent overlap)
+		std::vector< std::pair< Box const *, Box const * > > pairs;
+		for (uint32_t i = 0; pairs.size() < bench.count; ++i) {
+			pairs.emplace_back(&boxes[i % boxes.size()], &boxes[(i + 1) % boxes.size()]);
+		}
+		bench.run("hull_hull_collision", "boxes", pairs, [&](std::pair< Box const *, Box const * > const &f) {
+			CollisionResult result;
+			return hull_hull_collision(f.first->hull, f.second->hull, &result);
+		});
+	}
+
+	{ //broadphase: a room's worth of boxes, queried with player-sized capsules
+		std::vector< AABB > room_boxes;
+		AABBTree tree;
+		for (uint32_t i = 0; i < 1000; ++i) {
+			glm::vec3 center = glm::vec3(bench.uniform(-40.0f, 40.0f), bench.uniform(-40.0f, 40.0f), bench.uniform(0.0f, 5.0f));
+			glm::vec3 half = glm::vec3(bench.uniform(0.1f, 1.5f), bench.uniform(0.1f, 1.5f), bench.uniform(0.1f, 1.0f));
+			room_boxes.emplace_back(center - half, center + half);
+			tree.insert(room_boxes.back(), i);
+		}
+		std::vector< AABB > queries;
+		while (queries.size() < bench.count) {
+			glm::vec3 base = glm::vec3(bench.uniform(-40.0f, 40.0f), bench.uniform(-40.0f, 40.0f), bench.uniform(0.0f, 5.0f));
+			queries.emplace_back(AABB::around_segment(base, base + glm::vec3(0.0f, 0.0f, 1.0f), 0.5f));
+		}
+		bench.run("AABBTree::query", "room", queries, [&](AABB const &q) {
+			bool any = false;
+			tree.query(q, [&](uint32_t) { any = true; return false; });
+			return any;
+		});
+		bench.run("linear_overlap_scan", "room", queries, [&](AABB const &q) {
+			//same fat boxes the tree stores, so both report the same hits:
+			for (auto const &box : room_boxes) {
+				if (box.expanded(tree.margin).overlaps(q)) return true;
+			}
+			return false;
+		});
+
+		//camera-style rays: from a player-height point, 10 units in a random direction
+		std::vector< std::pair< glm::vec3, glm::vec3 > > rays;
+		while (rays.size() < bench.count) {
+			glm::vec3 origin = glm::vec3(bench.uniform(-40.0f, 40.0f), bench.uniform(-40.0f, 40.0f), bench.uniform(0.0f, 5.0f));
+			rays.emplace_back(origin, bench.direction());
+		}
+		bench.run("AABBTree::raycast", "room", rays, [&](std::pair< glm::vec3, glm::vec3 > const &r) {
+			bool any = false;
+			tree.raycast(r.first, r.second, 10.0f, [&](uint32_t, float max_t) { any = true; return max_t; });
+			return any;
+		});
+		bench.run("linear_ray_scan", "room", rays, [&](std::pair< glm::vec3, glm::vec3 > const &r) {
+			for (auto const &box : room_boxes) {
+				if (box.expanded(tree.margin).ray_overlaps(r.first, r.second, 10.0f)) return true;
+			}
+			return false;
+		});
+	}
+
+	{ //mesh colliders: a bumpy floor, through its BVH and through every batch in turn
+		std::vector< glm::vec3 > positions;
+		auto height = [](float x, float y) { return 0.3f * std::sin(0.7f * x) * std::cos(0.5f * y); };
+		for (uint32_t x = 0; x < 32; ++x) {
+			for (uint32_t y = 0; y < 32; ++y) {
+				glm::vec3 a = glm::vec3(x, y, height(x, y));
+				glm::vec3 b = glm::vec3(x + 1, y, height(x + 1, y));
+				glm::vec3 c = glm::vec3(x + 1, y + 1, height(x + 1, y + 1));
+				glm::vec3 d = glm::vec3(x, y + 1, height(x, y + 1));
+				positions.insert(positions.end(), { a, b, c, a, c, d });
+			}
+		}
+		MeshCollider mesh;
+		mesh.build(positions.data(), uint32_t(positions.size()), glm::mat4x3(1.0f));
+
+		std::vector< CapsuleShape > queries;
+		while (queries.size() < bench.count) {
+			glm::vec3 center = glm::vec3(bench.uniform(1.0f, 31.0f), bench.uniform(1.0f, 31.0f), bench.uniform(-0.2f, 0.8f));
+			queries.emplace_back(capsule_at(center, glm::vec3(0.0f, 0.0f, 1.0f), 0.3f, 0.5f));
+		}
+		bench.run("MeshCollider::capsule_collision", "floor", queries, [&](CapsuleShape const &q) {
+			CollisionResult result;
+			return mesh.capsule_collision(q.tip, q.base, q.radius, &result);
+		});
+		bench.run("capsule_triangle_batch_collision(all)", "floor", queries, [&](CapsuleShape const &q) {
+			CollisionResult result;
+			uint32_t index;
+			return capsule_triangle_batch_collision(q.tip, q.base, q.radius, mesh.batches.data(), uint32_t(mesh.batches.size()), &result, &index);
+		});
+	}
+
+	bench.print_json(std::cout, seed);
+	return bench.failed ? 1 : 0;
+}
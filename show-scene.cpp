@@ -113,8 +113,7 @@ int main(int argc, char **argv) {
 				if (!buffer_vao) return;
 				Mesh const &mesh = buffer->lookup(mesh_name);
 
-				scene.drawables.emplace_back(transform);
-				Scene::Drawable &drawable = scene.drawables.back();
+				Scene::Drawable &drawable = scene.drawables.emplace_back(transform);
 
 				drawable.pipeline = show_scene_program_pipeline;
 
@@ -122,6 +121,8 @@ int main(int argc, char **argv) {
 				drawable.pipeline.type = mesh.type;
 				drawable.pipeline.start = mesh.start;
 				drawable.pipeline.count = mesh.count;
+				drawable.min = mesh.min;
+				drawable.max = mesh.max;
 
 			});
 		} catch (std::exception &e) {